@@ -0,0 +1,164 @@
+# Python interface to the C++ decision tree (libppntree, see src/ppntree.h)
+# NumPy arrays are passed to the library in place: only a pointer, the shape and
+# the strides are sent, so no copy is made on the Python side.
+#
+# Build the library first:  cmake -S . -B build && cmake --build build
+# or point PPNTREE_LIBRARY to libppntree.so.
+
+import ctypes
+import os
+
+import numpy as np
+
+_here = os.path.dirname(os.path.abspath(__file__))
+_candidates = [
+    os.environ.get('PPNTREE_LIBRARY', ''),
+    os.path.join(_here, '..', 'build', 'libppntree.so'),
+]
+
+
+def _load_library():
+    for path in _candidates:
+        if path and os.path.exists(path):
+            return ctypes.CDLL(path)
+    raise OSError("libppntree.so not found, build it or set PPNTREE_LIBRARY")
+
+
+class _Params(ctypes.Structure):
+    _fields_ = [
+        ('max_depth', ctypes.c_int),
+        ('min_samples_split', ctypes.c_int),
+        ('min_gain', ctypes.c_double),
+        ('splitter', ctypes.c_int),
+        ('max_features', ctypes.c_int),
+        ('seed', ctypes.c_uint),
+        ('criterion', ctypes.c_int),
+    ]
+
+
+_CRITERIA = ['mse', 'friedman_mse', 'mae', 'poisson']
+
+_lib = _load_library()
+_double_p = ctypes.POINTER(ctypes.c_double)
+_long = ctypes.c_long
+
+_lib.ppntree_default_params.argtypes = [ctypes.POINTER(_Params)]
+_lib.ppntree_fit.restype = ctypes.c_void_p
+_lib.ppntree_fit.argtypes = [_double_p, _long, _long, _long, _long, _double_p, _long, ctypes.POINTER(_Params)]
+_lib.ppntree_predict_batch.argtypes = [ctypes.c_void_p, _double_p, _long, _long, _long, _long, _double_p]
+_lib.ppntree_save.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+_lib.ppntree_load.restype = ctypes.c_void_p
+_lib.ppntree_load.argtypes = [ctypes.c_char_p]
+_lib.ppntree_n_features.restype = _long
+_lib.ppntree_n_features.argtypes = [ctypes.c_void_p]
+_lib.ppntree_n_leaves.restype = _long
+_lib.ppntree_n_leaves.argtypes = [ctypes.c_void_p]
+_lib.ppntree_free.argtypes = [ctypes.c_void_p]
+_lib.ppntree_last_error.restype = ctypes.c_char_p
+
+
+def _as_doubles(array, ndim):
+    # float64 arrays (any layout) are used as they are, other types are converted
+    array = np.asarray(array, dtype=np.float64)
+    if array.ndim != ndim:
+        raise ValueError(f"expected a {ndim}-d array, got {array.ndim}-d")
+    strides = tuple(s // array.itemsize for s in array.strides)
+    return array, array.ctypes.data_as(_double_p), strides
+
+
+def _error():
+    return RuntimeError(_lib.ppntree_last_error().decode())
+
+
+class DecisionTreeRegressor:
+    """Regression tree trained and evaluated by libppntree."""
+
+    def __init__(self, max_depth=10, min_samples_split=10, min_gain=1e-7,
+                 splitter='best', max_features=0, seed=0, criterion='mse'):
+        self.params = _Params()
+        _lib.ppntree_default_params(ctypes.byref(self.params))
+        self.params.max_depth = max_depth
+        self.params.min_samples_split = min_samples_split
+        self.params.min_gain = min_gain
+        self.params.splitter = 1 if splitter == 'random' else 0
+        self.params.max_features = max_features
+        self.params.seed = seed
+        if criterion not in _CRITERIA:
+            raise ValueError(f"unknown criterion {criterion!r}, expected one of {_CRITERIA}")
+        self.params.criterion = _CRITERIA.index(criterion)
+        self._model = None
+
+    def __del__(self):
+        if getattr(self, '_model', None):
+            _lib.ppntree_free(self._model)
+
+    def fit(self, X, y):
+        X, X_p, (row_stride, col_stride) = _as_doubles(X, 2)
+        y, y_p, (y_stride,) = _as_doubles(y, 1)
+        if y.shape[0] != X.shape[0]:
+            raise ValueError("X and y have a different number of rows")
+        model = _lib.ppntree_fit(X_p, X.shape[0], X.shape[1], row_stride, col_stride,
+                                 y_p, y_stride, ctypes.byref(self.params))
+        if not model:
+            raise _error()
+        if self._model:
+            _lib.ppntree_free(self._model)
+        self._model = model
+        return self
+
+    def predict(self, X):
+        X, X_p, (row_stride, col_stride) = _as_doubles(X, 2)
+        out = np.empty(X.shape[0], dtype=np.float64)
+        if _lib.ppntree_predict_batch(self._model, X_p, X.shape[0], X.shape[1], row_stride, col_stride,
+                                      out.ctypes.data_as(_double_p)) != 0:
+            raise _error()
+        return out
+
+    @property
+    def n_leaves(self):
+        return _lib.ppntree_n_leaves(self._model)
+
+    def save(self, path):
+        if _lib.ppntree_save(self._model, path.encode()) != 0:
+            raise _error()
+
+    @classmethod
+    def load(cls, path):
+        model = _lib.ppntree_load(path.encode())
+        if not model:
+            raise _error()
+        tree = cls()
+        tree._model = model
+        return tree
+
+
+if __name__ == '__main__':
+    # Small benchmark against sklearn on the dataset used by predictions.py
+    import sys
+    import time
+
+    csv_file = sys.argv[1] if len(sys.argv) > 1 else os.path.join(_here, '..', 'datasets', '15k_ga_adaptive.csv')
+    data = np.loadtxt(csv_file, delimiter=',', skiprows=1)
+    X, y = data[:, :-1], data[:, -1]
+
+    start = time.perf_counter()
+    tree = DecisionTreeRegressor(max_depth=10, min_samples_split=2).fit(X, y)
+    fit_time = time.perf_counter() - start
+    start = time.perf_counter()
+    pred = tree.predict(X)
+    predict_time = time.perf_counter() - start
+    print(f"ppntree: fit {fit_time:.3f}s, predict {predict_time:.4f}s, "
+          f"{tree.n_leaves} leaves, train MSE {np.mean((pred - y) ** 2):.6g}")
+
+    try:
+        from sklearn import tree as sk_tree
+    except ImportError:
+        sys.exit(0)
+    start = time.perf_counter()
+    clf = sk_tree.DecisionTreeRegressor(max_depth=10).fit(X, y)
+    fit_time = time.perf_counter() - start
+    start = time.perf_counter()
+    pred = clf.predict(X)
+    predict_time = time.perf_counter() - start
+    print(f"sklearn: fit {fit_time:.3f}s, predict {predict_time:.4f}s, "
+          f"{clf.get_n_leaves()} leaves, train MSE {np.mean((pred - y) ** 2):.6g}")
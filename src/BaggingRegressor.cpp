@@ -0,0 +1,142 @@
+#include "BaggingRegressor.hpp"
+#include "criteria.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+/**
+ * @brief Draws a bootstrap sample of n rows as row multiplicities.
+ *
+ * n rows are drawn uniformly with replacement; a count saturates at 255,
+ * which has negligible probability for n draws among n rows.
+ */
+static std::vector<uint8_t> bootstrap_counts(int n, unsigned seed, int tree)
+{
+    std::seed_seq seq{seed, static_cast<unsigned>(tree)};
+    std::mt19937 rng(seq);
+    std::uniform_int_distribution<int> pick(0, n - 1);
+
+    std::vector<uint8_t> counts(n, 0);
+    for (int i = 0; i < n; ++i) {
+        uint8_t& c = counts[pick(rng)];
+        if (c < 255) ++c;
+    }
+    return counts;
+}
+
+/**
+ * @brief Trains the ensemble on X, y and computes the out-of-bag error.
+ *
+ * Tree t uses the bootstrap and the seed (seed + t) of its index, and the
+ * out-of-bag predictions are summed in tree order, so the model and the
+ * error do not depend on n_threads. Rows that no tree left out are not
+ * counted in oob_rmse / oob_r2.
+ */
+void BaggingRegressor::fit(const std::vector<std::vector<double>>& X, const std::vector<double>& y)
+{
+    int n = X.size();
+    trees.clear();
+    counts.assign(n_estimators, std::vector<uint8_t>());
+    for (int t = 0; t < n_estimators; ++t) {
+        trees.emplace_back(new DecisionTreeRegressor());
+        DecisionTreeRegressor& tree = *trees.back();
+        tree.max_depth = max_depth;
+        tree.min_samples_split = min_samples_split;
+        tree.min_gain = min_gain;
+        tree.splitter = splitter;
+        tree.criterion = criterion;
+        tree.max_features = max_features;
+        tree.seed = seed + t;
+    }
+    oob_prediction.assign(n, std::numeric_limits<double>::quiet_NaN());
+    oob_rmse = oob_r2 = 0.0;
+    if (n == 0 || n_estimators <= 0) return;
+    // Here rather than in the workers, where an exception would terminate the program
+    if (criterion == SplitCriterion::Poisson)
+        check_poisson_targets(y);
+
+    // One job per tree
+    std::atomic<int> next_tree(0);
+    auto train_worker = [&]() {
+        for (int t = next_tree++; t < n_estimators; t = next_tree++) {
+            counts[t] = bootstrap_counts(n, seed, t);
+            trees[t]->fit_bootstrap(X, y, counts[t]);
+        }
+    };
+
+    // One job per block of rows: mean prediction of the trees that left each row out
+    const int block = 1024;
+    int blocks = (n + block - 1) / block;
+    std::atomic<int> next_block(0);
+    auto oob_worker = [&]() {
+        for (int b = next_block++; b < blocks; b = next_block++) {
+            for (int i = b * block; i < std::min(n, (b + 1) * block); ++i) {
+                double sum = 0.0;
+                int votes = 0;
+                for (int t = 0; t < n_estimators; ++t) {
+                    if (counts[t][i] == 0 && trees[t]->root) {
+                        sum += trees[t]->predict(X[i]);
+                        ++votes;
+                    }
+                }
+                if (votes > 0) oob_prediction[i] = sum / votes;
+            }
+        }
+    };
+
+    int workers = n_threads > 0 ? n_threads : std::max(1u, std::thread::hardware_concurrency());
+    auto run = [&](auto worker, int jobs) {
+        std::vector<std::thread> threads;
+        for (int w = 1; w < std::min(workers, jobs); ++w)
+            threads.emplace_back(worker);
+        worker();
+        for (std::thread& th : threads)
+            th.join();
+    };
+    run(train_worker, n_estimators);
+    run(oob_worker, blocks);
+
+    double sse = 0.0, sum = 0.0, sum_sq = 0.0;
+    int scored = 0;
+    for (int i = 0; i < n; ++i) {
+        if (std::isnan(oob_prediction[i])) continue;
+        double d = oob_prediction[i] - y[i];
+        sse += d * d;
+        sum += y[i];
+        sum_sq += y[i] * y[i];
+        ++scored;
+    }
+    if (scored > 0) {
+        double sst = sum_sq - sum * sum / scored;
+        oob_rmse = std::sqrt(sse / scored);
+        oob_r2 = sst > 0.0 ? 1.0 - sse / sst : 0.0;
+    }
+}
+
+/**
+ * @brief Mean prediction of the trees.
+ */
+double BaggingRegressor::predict(const std::vector<double>& x) const
+{
+    double sum = 0.0;
+    int votes = 0;
+    for (const auto& tree : trees) {
+        if (!tree->root) continue;
+        sum += tree->predict(x);
+        ++votes;
+    }
+    return votes > 0 ? sum / votes : 0.0;
+}
+
+/**
+ * @brief Roots of the trained trees, for QuickScorer, partial_dependence(), ...
+ */
+std::vector<Node*> BaggingRegressor::roots() const
+{
+    std::vector<Node*> result;
+    for (const auto& tree : trees)
+        if (tree->root) result.push_back(tree->root);
+    return result;
+}
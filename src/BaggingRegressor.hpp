@@ -0,0 +1,40 @@
+#pragma once
+#include "DecisionTreeRegressor.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Bagging ensemble of DecisionTreeRegressor with out-of-bag error.
+ *
+ * Each tree is trained on a bootstrap sample of the rows, stored as one
+ * multiplicity per row (uint8_t, n bytes per tree) instead of copied rows:
+ * row i weighs counts[t][i] in tree t, 0 meaning out of bag. The trees are
+ * trained in parallel. At the end of fit() every row is predicted by the
+ * trees that did not see it, which gives the out-of-bag RMSE and R² without
+ * retraining or a held-out set.
+ */
+class BaggingRegressor {
+public:
+    int n_estimators = 100;
+    unsigned seed = 0;
+    int n_threads = 0;              // training threads (0 = one per core)
+
+    // Parameters of every tree (see DecisionTreeRegressor)
+    int max_depth = 10;
+    int min_samples_split = 10;
+    double min_gain = 1e-7;
+    SplitStrategy splitter = SplitStrategy::Best;
+    SplitCriterion criterion = SplitCriterion::MSE;
+    int max_features = 0;
+
+    std::vector<std::unique_ptr<DecisionTreeRegressor>> trees;
+    std::vector<std::vector<uint8_t>> counts;   // bootstrap multiplicities, counts[tree][row]
+    std::vector<double> oob_prediction;         // NaN for rows that were in every bootstrap
+    double oob_rmse = 0.0;
+    double oob_r2 = 0.0;
+
+    void fit(const std::vector<std::vector<double>>& X, const std::vector<double>& y);
+    double predict(const std::vector<double>& x) const;
+    std::vector<Node*> roots() const;
+};
@@ -0,0 +1,499 @@
+#include "DecisionTreeRegressor.hpp"
+#include "pruning.hpp"
+#include "importance.hpp"
+#include "criteria.hpp"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief True for the criteria whose leaves predict the mean and whose cost is
+ * the squared error, i.e. those the node statistics (count, Σy, Σy²) describe.
+ */
+static bool squared_error(SplitCriterion criterion)
+{
+    return criterion == SplitCriterion::MSE || criterion == SplitCriterion::FriedmanMSE;
+}
+
+/**
+ * @brief Trains the tree on X, y. Any previous tree is released.
+ *
+ * The random generator is re-seeded with `seed`, so two fits with the same
+ * parameters and data give the same tree. The rows are copied for update()
+ * only if keep_training_data is set. feature_importances is filled from the
+ * SSE reductions of the splits (see importances()).
+ */
+void DecisionTreeRegressor::fit(const std::vector<std::vector<double>>& X,
+                                const std::vector<double>& y)
+{
+    fit(X, y, std::vector<double>());
+}
+
+/**
+ * @brief Trains the tree on weighted rows (empty sample_weight: all weights are 1).
+ *
+ * A row of weight w counts as w identical rows: in min_samples_split, in the
+ * split criteria, in the leaf values and in the node statistics. A node whose
+ * rows all have weight 0 is an empty leaf (see build()).
+ *
+ * @throws std::invalid_argument if sample_weight is not empty and differs from
+ *         X in size, or holds a negative weight.
+ */
+void DecisionTreeRegressor::fit(const std::vector<std::vector<double>>& X,
+                                const std::vector<double>& y,
+                                const std::vector<double>& sample_weight)
+{
+    if (!sample_weight.empty() && sample_weight.size() != X.size())
+        throw std::invalid_argument("DecisionTreeRegressor::fit: sample_weight and X differ in size");
+    for (double w : sample_weight)
+        if (!(w >= 0.0))
+            throw std::invalid_argument("DecisionTreeRegressor::fit: negative or NaN sample weight");
+
+    w_train = sample_weight;
+    y_sq_train.clear();
+    train(X, y);
+}
+
+/**
+ * @brief Trains the tree on deduplicated rows (see deduplicate()).
+ *
+ * Each distinct row has the mean of its duplicates as target and their count
+ * as weight, so the splits and leaf values are those of the full dataset
+ * (except for MAE, whose medians are taken over the means). Σy² keeps the
+ * node statistics and the variance stop rule exact.
+ */
+void DecisionTreeRegressor::fit(const WeightedRows& rows)
+{
+    w_train = rows.count;
+    y_sq_train = rows.sum_sq;
+    train(rows.X, rows.mean());
+}
+
+/**
+ * @brief Trains the tree on a bootstrap sample given as row multiplicities.
+ *
+ * Row i counts as counts[i] identical rows (0: out of bag, not visited).
+ * X and y are read in place: neither they nor the weights are kept after
+ * the fit, even with keep_training_data, so update() is not available.
+ * A bootstrap whose targets sum to 0 (Poisson) gives a single leaf.
+ */
+void DecisionTreeRegressor::fit_bootstrap(const std::vector<std::vector<double>>& X,
+                                          const std::vector<double>& y,
+                                          const std::vector<uint8_t>& counts)
+{
+    X_train.clear();
+    y_train.clear();
+    y_sq_train.clear();
+    w_train.assign(counts.begin(), counts.end());
+
+    // On all of y, as BaggingRegressor::fit() does before starting its threads
+    if (criterion == SplitCriterion::Poisson)
+        check_poisson_targets(y);
+
+    std::vector<int> indices;
+    for (size_t i = 0; i < counts.size(); ++i)
+        if (counts[i] > 0) indices.push_back(i);
+
+    free_tree(root);
+    root = nullptr;
+    rng.seed(seed);
+    if (!indices.empty()) {
+        root = build(indices, X, y, 0);
+        feature_importances = importances(X[0].size());
+    }
+    std::vector<double>().swap(w_train);
+}
+
+/**
+ * @brief Builds the tree on X, y (weights in w_train / y_sq_train). Any previous tree is released.
+ *
+ * With keep_training_data the rows are copied to X_train / y_train for
+ * update(); otherwise they are only read, and the weights are released.
+ */
+void DecisionTreeRegressor::train(const std::vector<std::vector<double>>& X,
+                                  const std::vector<double>& y)
+{
+    if (criterion == SplitCriterion::Poisson)
+        check_poisson_targets(y, w_train.empty() ? nullptr : &w_train);
+
+    free_tree(root);
+    root = nullptr;
+    rng.seed(seed);
+
+    X_train.clear();
+    y_train.clear();
+    if (keep_training_data) {
+        X_train = X;
+        y_train = y;
+    }
+
+    std::vector<int> indices(X.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    root = build(indices, X, y, 0);
+    feature_importances = importances(X.empty() ? 0 : X[0].size());
+
+    if (!keep_training_data) {
+        std::vector<double>().swap(w_train);
+        std::vector<double>().swap(y_sq_train);
+    }
+}
+
+/**
+ * @brief Calls visit(C()) with the criterion type C matching `criterion`.
+ *
+ * Each criterion thus gets its own instantiation of the templated scans.
+ */
+template <class Visitor>
+static auto with_criterion(SplitCriterion criterion, Visitor visit)
+{
+    switch (criterion) {
+    case SplitCriterion::FriedmanMSE: return visit(FriedmanMSECriterion());
+    case SplitCriterion::MAE: return visit(MAECriterion());
+    case SplitCriterion::Poisson: return visit(PoissonCriterion());
+    default: return visit(MSECriterion());
+    }
+}
+
+/**
+ * @brief Values of the given rows (empty if y is empty, e.g. unweighted rows).
+ */
+static std::vector<double> gather(const std::vector<double>& y, const std::vector<int>& indices)
+{
+    std::vector<double> values;
+    if (y.empty()) return values;
+    values.reserve(indices.size());
+    for (int i : indices) values.push_back(y[i]);
+    return values;
+}
+
+/**
+ * @brief Adds new rows to a trained tree without refitting it completely.
+ *
+ * Each new row is routed to its leaf and the statistics (count, Σy, Σy²) and
+ * values of all nodes on its path are updated. Then only the nodes that
+ * received more than update_tolerance × samples new rows since they were
+ * last checked are re-evaluated:
+ * - a leaf is rebuilt from its rows, so it can be split if it grew enough;
+ * - an internal node is rebuilt if its current split now loses more than
+ *   update_tolerance of the impurity reduction of the best split of its rows.
+ * Other subtrees are kept as they are.
+ *
+ * Needs the rows of the previous fit: throws std::logic_error if the tree
+ * was fitted without keep_training_data (or by fit_bootstrap()).
+ *
+ * @throws std::invalid_argument if new_X and new_y differ in size, or a row
+ *         of new_X does not have the feature count of the fitted rows.
+ */
+void DecisionTreeRegressor::update(const std::vector<std::vector<double>>& new_X,
+                                   const std::vector<double>& new_y)
+{
+    if (new_X.size() != new_y.size())
+        throw std::invalid_argument("DecisionTreeRegressor::update: new_X and new_y differ in size");
+    if (!root) {
+        fit(new_X, new_y);
+        return;
+    }
+    if (X_train.empty())
+        throw std::logic_error("DecisionTreeRegressor::update: fit with keep_training_data = true first");
+    for (const std::vector<double>& row : new_X)
+        if (row.size() != X_train[0].size())
+            throw std::invalid_argument("DecisionTreeRegressor::update: expected " +
+                                        std::to_string(X_train[0].size()) + " features, got " +
+                                        std::to_string(row.size()));
+
+    for (size_t i = 0; i < new_X.size(); ++i) {
+        X_train.push_back(new_X[i]);
+        y_train.push_back(new_y[i]);
+        if (!w_train.empty()) w_train.push_back(1.0);
+        if (!y_sq_train.empty()) y_sq_train.push_back(new_y[i] * new_y[i]);
+
+        double v = new_y[i];
+        Node* node = root;
+        while (true) {
+            node->samples += 1;
+            node->sum += v;
+            node->sum_sq += v * v;
+            node->new_samples += 1;
+            if (criterion != SplitCriterion::MAE)   // medians are recomputed by refresh()
+                node->value = node->sum / node->samples;
+            if (node->is_leaf) break;
+            node = new_X[i][node->feature_index] <= node->threshold ? node->left : node->right;
+        }
+    }
+
+    std::vector<int> indices(X_train.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    refresh(root, indices, 0);
+    feature_importances = importances(X_train[0].size());
+}
+
+/**
+ * @brief Re-evaluates the subtrees that received new rows (see update()).
+ *
+ * @param indices Rows of the training data that belong to the node.
+ */
+void DecisionTreeRegressor::refresh(Node* node, const std::vector<int>& indices, int depth)
+{
+    if (node->new_samples == 0)
+        return;
+
+    if (criterion == SplitCriterion::MAE) {
+        // update() only moves the means: the median is taken again from the rows
+        std::vector<double> node_y = gather(y_train, indices);
+        std::vector<double> node_w = gather(w_train, indices);
+        node->value = MAECriterion::leaf_value(node_y, w_train.empty() ? nullptr : &node_w);
+    }
+
+    bool stale = node->new_samples > update_tolerance * node->samples;
+
+    if (node->is_leaf) {
+        if (stale)
+            rebuild(node, indices, depth);
+        return;
+    }
+
+    if (stale) {
+        node->new_samples = 0;
+        Split best = find_best_split(indices, X_train, y_train);
+        std::vector<int> current_feature{node->feature_index};
+        std::vector<double> current_threshold{node->threshold};
+        const std::vector<double>* weights = w_train.empty() ? nullptr : &w_train;
+        double current_cost = with_criterion(criterion, [&](auto c) {
+            return score_thresholds<decltype(c)>(X_train, y_train, indices,
+                                                 current_feature, current_threshold, weights).sse;
+        });
+        std::vector<double> node_y = gather(y_train, indices);
+        std::vector<double> node_w = gather(w_train, indices);
+        double best_gain = with_criterion(criterion, [&](auto c) {
+            return criterion_impurity<decltype(c)>(node_y, weights ? &node_w : nullptr);
+        }) - best.sse;
+        if (best.feature != -1 && current_cost - best.sse > update_tolerance * best_gain) {
+            rebuild(node, indices, depth);
+            return;
+        }
+    }
+
+    std::vector<int> left, right;
+    for (int i : indices) {
+        if (X_train[i][node->feature_index] <= node->threshold)
+            left.push_back(i);
+        else
+            right.push_back(i);
+    }
+    refresh(node->left, left, depth + 1);
+    refresh(node->right, right, depth + 1);
+}
+
+/**
+ * @brief Replaces a subtree, in place, by a new subtree fitted on its rows.
+ */
+void DecisionTreeRegressor::rebuild(Node* node, const std::vector<int>& indices, int depth)
+{
+    Node* fresh = build(indices, X_train, y_train, depth);
+    free_tree(node->left);
+    free_tree(node->right);
+    *node = *fresh;
+    delete fresh;
+}
+
+/**
+ * @brief Cost-complexity pruning of the trained tree, alpha chosen on X_val, y_val.
+ *
+ * The pruning path is built on the SSE of the nodes and collapsed nodes
+ * predict their mean, so only the squared-error criteria are supported.
+ *
+ * @return Selected alpha (see prune_with_validation()).
+ * @throws std::invalid_argument for the MAE and Poisson criteria.
+ */
+double DecisionTreeRegressor::prune(const std::vector<std::vector<double>>& X_val,
+                                    const std::vector<double>& y_val)
+{
+    if (!squared_error(criterion))
+        throw std::invalid_argument("DecisionTreeRegressor::prune: only the MSE and FriedmanMSE criteria are supported");
+    return prune_with_validation(root, X_val, y_val);
+}
+
+/**
+ * @brief Split-gain importance of the tree (split_gain_importance()).
+ *
+ * It measures SSE reductions, which are not what the MAE and Poisson splits
+ * minimize: for those criteria the result is empty.
+ */
+std::vector<double> DecisionTreeRegressor::importances(int n_features) const
+{
+    if (!squared_error(criterion))
+        return {};
+    return split_gain_importance(root, n_features);
+}
+
+/**
+ * @brief Predicts the value of one sample with the trained tree.
+ */
+double DecisionTreeRegressor::predict(const std::vector<double>& x) const
+{
+    return ::predict(root, x);
+}
+
+/**
+ * @brief Recursively builds the subtree of the given rows.
+ *
+ * A node is split if it is above max_depth, has at least min_samples_split
+ * rows (total weight), an impurity per row above min_gain, and its best split
+ * lowers the impurity of the criterion, per row, by more than min_gain.
+ * Leaves hold the value given by the criterion.
+ */
+Node* DecisionTreeRegressor::build(const std::vector<int>& indices,
+                                   const std::vector<std::vector<double>>& X,
+                                   const std::vector<double>& y,
+                                   int depth)
+{
+    Node* node = new Node();
+
+    std::vector<double> node_y = gather(y, indices);
+    std::vector<double> node_w = gather(w_train, indices);
+    const std::vector<double>* weights = w_train.empty() ? nullptr : &node_w;
+
+    if (weights)
+        set_node_stats(node, node_y, node_w);
+    else
+        set_node_stats(node, node_y);
+    if (node->samples <= 0.0) {
+        // No rows, or only rows of weight 0: an empty leaf, which gets its
+        // parent's value (0 at the root)
+        node->is_leaf = true;
+        node->value = 0.0;
+        return node;
+    }
+
+    double current_mse;
+    if (weights) {
+        current_mse = criterion_impurity<MSECriterion>(node_y, weights) / node->samples;
+        if (!y_sq_train.empty()) {
+            // Merged rows: add the spread of y inside each group of duplicates
+            double within = 0.0;
+            node->sum_sq = 0.0;
+            for (int i : indices) {
+                node->sum_sq += y_sq_train[i];
+                within += y_sq_train[i] - w_train[i] * y[i] * y[i];
+            }
+            current_mse += std::max(0.0, within) / node->samples;
+        }
+    } else {
+        current_mse = mse(node_y);
+    }
+    node->value = with_criterion(criterion, [&](auto c) {
+        return decltype(c)::leaf_value(node_y, weights);
+    });
+
+    double impurity = with_criterion(criterion, [&](auto c) {
+        return criterion_impurity<decltype(c)>(node_y, weights);
+    });
+    // Impurity per row for the stop rule: the variance for the squared-error
+    // criteria (FriedmanMSE has no impurity of its own), the criterion's otherwise
+    double node_impurity = squared_error(criterion) ? current_mse : impurity / node->samples;
+
+    if (depth >= max_depth || node->samples < min_samples_split || node_impurity <= min_gain) {
+        node->is_leaf = true;
+        return node;
+    }
+
+    Split split = find_best_split(indices, X, y);
+    double gain = (impurity - split.sse) / node->samples;
+    if (split.feature == -1 || gain <= min_gain) {
+        node->is_leaf = true;
+        return node;
+    }
+
+    std::vector<int> left, right;
+    for (int i : indices) {
+        if (X[i][split.feature] <= split.threshold)
+            left.push_back(i);
+        else
+            right.push_back(i);
+    }
+
+    node->feature_index = split.feature;
+    node->threshold = split.threshold;
+    node->left = build(left, X, y, depth + 1);
+    node->right = build(right, X, y, depth + 1);
+    for (Node* child : {node->left, node->right})
+        if (child->samples <= 0.0)
+            child->value = node->value;
+    return node;
+}
+
+/**
+ * @brief Draws the candidate features of a node (all of them if max_features is 0).
+ */
+std::vector<int> DecisionTreeRegressor::draw_features(int m)
+{
+    std::vector<int> features(m);
+    std::iota(features.begin(), features.end(), 0);
+    if (max_features <= 0 || max_features >= m)
+        return features;
+
+    // Partial Fisher-Yates shuffle: the first max_features entries are the draw
+    for (int i = 0; i < max_features; ++i) {
+        std::uniform_int_distribution<int> pick(i, m - 1);
+        std::swap(features[i], features[pick(rng)]);
+    }
+    features.resize(max_features);
+    return features;
+}
+
+/**
+ * @brief Finds the split of a node with the chosen strategy and criterion.
+ *
+ * The sse field of the result holds the cost of the split for the criterion.
+ */
+Split DecisionTreeRegressor::find_best_split(const std::vector<int>& indices,
+                                             const std::vector<std::vector<double>>& X,
+                                             const std::vector<double>& y)
+{
+    std::vector<int> features = draw_features(X[indices[0]].size());
+    if (splitter == SplitStrategy::Random)
+        return find_random_split(indices, X, y, features);
+    if (criterion == SplitCriterion::MSE && w_train.empty())
+        return ::find_best_split(X, y, indices, 1, 0, nullptr, &features);
+    const std::vector<double>* weights = w_train.empty() ? nullptr : &w_train;
+    return with_criterion(criterion, [&](auto c) {
+        return find_best_split_with<decltype(c)>(X, y, indices, 1, &features, weights);
+    });
+}
+
+/**
+ * @brief Extremely randomized split: one random threshold per candidate feature.
+ *
+ * For each feature, one pass finds its range in the node and a threshold is
+ * drawn uniformly in [min, max). The thresholds are then scored with the
+ * criterion in one more pass per feature. No sorting is needed, so a node
+ * costs O(n) per feature (O(n log n) for MAE).
+ */
+Split DecisionTreeRegressor::find_random_split(const std::vector<int>& indices,
+                                               const std::vector<std::vector<double>>& X,
+                                               const std::vector<double>& y,
+                                               const std::vector<int>& features)
+{
+    std::vector<int> candidates;
+    std::vector<double> thresholds;
+
+    for (int feature : features) {
+        double lo = X[indices[0]][feature], hi = lo;
+        for (int i : indices) {
+            lo = std::min(lo, X[i][feature]);
+            hi = std::max(hi, X[i][feature]);
+        }
+        if (!(lo < hi))
+            continue;
+
+        std::uniform_real_distribution<double> draw(lo, hi);
+        candidates.push_back(feature);
+        thresholds.push_back(draw(rng));
+    }
+
+    const std::vector<double>* weights = w_train.empty() ? nullptr : &w_train;
+    return with_criterion(criterion, [&](auto c) {
+        return score_thresholds<decltype(c)>(X, y, indices, candidates, thresholds, weights);
+    });
+}
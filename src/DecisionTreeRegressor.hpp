@@ -1,6 +1,28 @@
 #pragma once
-#include "Node.hpp"
+#include "decision_tree.hpp"
+#include "dedup.hpp"
+#include <cstdint>
 #include <vector>
+#include <random>
+
+/**
+ * @brief How the threshold of a split is chosen.
+ *
+ * Best: every threshold of every candidate feature is scored (exact search).
+ * Random: one threshold drawn uniformly between the min and max of each
+ *         candidate feature in the node (Extremely Randomized Trees).
+ */
+enum class SplitStrategy { Best, Random };
+
+/**
+ * @brief Impurity minimized by the splits (see criteria.hpp).
+ *
+ * MSE: squared error, leaves predict the mean (SIMD kernel for Best splits).
+ * FriedmanMSE: Friedman's improvement score, leaves predict the mean.
+ * MAE: absolute error, leaves predict the median.
+ * Poisson: Poisson deviance, for positive targets, leaves predict the mean.
+ */
+enum class SplitCriterion { MSE, FriedmanMSE, MAE, Poisson };
 
 class DecisionTreeRegressor {
 public:
@@ -8,18 +30,50 @@ public:
     int max_depth = 10;
     int min_samples_split = 10;
     double min_gain = 1e-7;
+    SplitStrategy splitter = SplitStrategy::Best;
+    SplitCriterion criterion = SplitCriterion::MSE;
+    int max_features = 0;           // features drawn at each node (0 = all)
+    unsigned seed = 0;
+    double update_tolerance = 0.1;  // see update()
+    bool keep_training_data = false;    // copy the rows in fit(), needed by update()
+    std::vector<double> feature_importances;   // split-gain importance, set by fit() / update() (MSE, FriedmanMSE)
+
+    DecisionTreeRegressor() = default;
+    DecisionTreeRegressor(const DecisionTreeRegressor&) = delete;
+    DecisionTreeRegressor& operator=(const DecisionTreeRegressor&) = delete;
 
     void fit(const std::vector<std::vector<double>>& X, const std::vector<double>& y);
+    void fit(const std::vector<std::vector<double>>& X, const std::vector<double>& y,
+             const std::vector<double>& sample_weight);
+    void fit(const WeightedRows& rows);
+    void fit_bootstrap(const std::vector<std::vector<double>>& X, const std::vector<double>& y,
+                       const std::vector<uint8_t>& counts);
+    void update(const std::vector<std::vector<double>>& new_X, const std::vector<double>& new_y);
+    double prune(const std::vector<std::vector<double>>& X_val, const std::vector<double>& y_val);
     double predict(const std::vector<double>& x) const;
-    ~DecisionTreeRegressor() { delete root; }
+    ~DecisionTreeRegressor() { free_tree(root); }
 
 private:
-    Node* build(const std::vector<size_t>& indices,
+    std::mt19937 rng;
+    std::vector<std::vector<double>> X_train;   // rows seen by fit() and update() (keep_training_data)
+    std::vector<double> y_train;
+    std::vector<double> w_train;                // sample weights (empty: all 1)
+    std::vector<double> y_sq_train;             // Σy² of merged rows (empty: y²)
+
+    void train(const std::vector<std::vector<double>>& X, const std::vector<double>& y);
+    Node* build(const std::vector<int>& indices,
                 const std::vector<std::vector<double>>& X,
                 const std::vector<double>& y,
                 int depth);
-    std::pair<int, double> find_best_split(const std::vector<size_t>& indices,
-                                           const std::vector<std::vector<double>>& X,
-                                           const std::vector<double>& y);
-    double mse(const std::vector<double>& y);
-};
\ No newline at end of file
+    Split find_best_split(const std::vector<int>& indices,
+                          const std::vector<std::vector<double>>& X,
+                          const std::vector<double>& y);
+    Split find_random_split(const std::vector<int>& indices,
+                            const std::vector<std::vector<double>>& X,
+                            const std::vector<double>& y,
+                            const std::vector<int>& features);
+    std::vector<int> draw_features(int m);
+    void refresh(Node* node, const std::vector<int>& indices, int depth);
+    void rebuild(Node* node, const std::vector<int>& indices, int depth);
+    std::vector<double> importances(int n_features) const;
+};
@@ -0,0 +1,432 @@
+#ifndef CRITERIA_HPP
+#define CRITERIA_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include "decision_tree.hpp"
+
+/*
+ * Split criteria with incremental updates.
+ *
+ * A criterion provides an Accumulator, built once per node from the target
+ * values (and optional sample weights) of the node and updated in O(1) or
+ * O(log n) when a row (given by its index k in the node) enters or leaves
+ * one side of the split, and:
+ *   cost(left, right): value to minimize over the thresholds;
+ *   impurity(all): cost of the node before the split (same units);
+ *   leaf_value(values, weights): prediction of a leaf.
+ * The split search below is templated on the criterion, so each criterion
+ * gets its own specialized scan loop.
+ */
+
+/**
+ * @brief Weight of the row k of a node (1 without weights).
+ */
+inline double row_weight(const std::vector<double>* weights, int k)
+{
+    return weights ? (*weights)[k] : 1.0;
+}
+
+/**
+ * @brief Running weight, sum and sum of squares of y (centered on the node mean).
+ */
+class MomentAccumulator {
+public:
+    explicit MomentAccumulator(const std::vector<double>& values,
+                               const std::vector<double>* weights = nullptr)
+        : values(values), weights(weights) {
+        double total = 0.0;
+        for (size_t k = 0; k < values.size(); ++k) {
+            c += row_weight(weights, k) * values[k];
+            total += row_weight(weights, k);
+        }
+        if (total > 0.0) c /= total;
+    }
+
+    void clear() { n = s = s2 = 0.0; }
+    void add(int k) { double w = row_weight(weights, k), v = values[k] - c; n += w; s += w * v; s2 += w * v * v; }
+    void remove(int k) { double w = row_weight(weights, k), v = values[k] - c; n -= w; s -= w * v; s2 -= w * v * v; }
+
+    double count() const { return n; }
+    double mean() const { return c + s / n; }
+    double sse() const { return n > 0.0 ? std::max(0.0, s2 - s * s / n) : 0.0; }
+
+private:
+    const std::vector<double>& values;
+    const std::vector<double>* weights;
+    double c = 0.0;
+    double n = 0.0, s = 0.0, s2 = 0.0;
+};
+
+/**
+ * @brief Squared error: minimizes the SSE of the two children.
+ */
+struct MSECriterion {
+    using Accumulator = MomentAccumulator;
+
+    static double cost(const Accumulator& left, const Accumulator& right) {
+        return left.sse() + right.sse();
+    }
+    static double impurity(const Accumulator& all) { return all.sse(); }
+    static double leaf_value(const std::vector<double>& values,
+                             const std::vector<double>* weights = nullptr) {
+        if (!weights) return mean(values);
+        Accumulator all(values, weights);
+        for (size_t k = 0; k < values.size(); ++k) all.add(k);
+        return all.mean();
+    }
+};
+
+/**
+ * @brief Friedman's improvement score nl·nr / (nl + nr) · (mean_l - mean_r)², maximized.
+ */
+struct FriedmanMSECriterion {
+    using Accumulator = MomentAccumulator;
+
+    static double cost(const Accumulator& left, const Accumulator& right) {
+        double nl = left.count(), nr = right.count();
+        double diff = left.mean() - right.mean();
+        return -nl * nr / (nl + nr) * diff * diff;
+    }
+    static double impurity(const Accumulator&) { return 0.0; }
+    static double leaf_value(const std::vector<double>& values,
+                             const std::vector<double>* weights = nullptr) {
+        if (!weights) return mean(values);
+        Accumulator all(values, weights);
+        for (size_t k = 0; k < values.size(); ++k) all.add(k);
+        return all.mean();
+    }
+};
+
+/**
+ * @brief Order-statistic tree over the ranks of the node values (Fenwick tree).
+ *
+ * Holds the weight and the weighted sum of the values present on one side.
+ * The (weighted lower) median and the sum of absolute deviations to it are
+ * found in O(log n).
+ */
+class MedianAccumulator {
+public:
+    explicit MedianAccumulator(const std::vector<double>& values,
+                               const std::vector<double>* weights = nullptr)
+        : values(values), weights(weights) {
+        n = values.size();
+        std::vector<int> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return values[a] < values[b]; });
+
+        rank.resize(n);
+        sorted.resize(n);
+        sorted_weight.resize(n);
+        for (int r = 0; r < n; ++r) {
+            rank[order[r]] = r + 1;
+            sorted[r] = values[order[r]];
+            sorted_weight[r] = row_weight(weights, order[r]);
+        }
+        top = 1;
+        while (top * 2 <= n) top *= 2;
+        clear();
+    }
+
+    void clear() {
+        counts.assign(n + 1, 0.0);
+        sums.assign(n + 1, 0.0);
+        size = 0.0;
+        total = 0.0;
+    }
+    void add(int k) { double w = row_weight(weights, k); update(rank[k], w, w * values[k]); }
+    void remove(int k) { double w = row_weight(weights, k); update(rank[k], -w, -w * values[k]); }
+
+    double count() const { return size; }
+
+    /**
+     * @brief Lower median of the values present, and the sum of |y - median|.
+     *
+     * The median is the first value (in sorted order) where the cumulated
+     * weight reaches half of the total weight.
+     */
+    double median(double* abs_deviation = nullptr) const {
+        if (size <= 0.0) {
+            if (abs_deviation) *abs_deviation = 0.0;
+            return 0.0;
+        }
+        double half = size / 2.0;
+        int pos = 0;
+        double below = 0.0, below_sum = 0.0;
+        for (int step = top; step > 0; step >>= 1) {
+            if (pos + step <= n && below + counts[pos + step] < half) {
+                pos += step;
+                below += counts[pos];
+                below_sum += sums[pos];
+            }
+        }
+        double med = sorted[pos];
+        if (abs_deviation) {
+            double low_n = below + sorted_weight[pos], low_sum = below_sum + sorted_weight[pos] * med;
+            *abs_deviation = (med * low_n - low_sum) + ((total - low_sum) - med * (size - low_n));
+        }
+        return med;
+    }
+
+    double sae() const {
+        double deviation;
+        median(&deviation);
+        return deviation;
+    }
+
+private:
+    const std::vector<double>& values;
+    const std::vector<double>* weights;
+    int n = 0, top = 1;
+    double size = 0.0, total = 0.0;
+    std::vector<int> rank;          // 1-based position of each value in sorted order
+    std::vector<double> sorted;
+    std::vector<double> sorted_weight;
+    std::vector<double> counts;
+    std::vector<double> sums;
+
+    void update(int i, double dc, double ds) {
+        size += dc;
+        total += ds;
+        for (; i <= n; i += i & -i) {
+            counts[i] += dc;
+            sums[i] += ds;
+        }
+    }
+};
+
+/**
+ * @brief Absolute error: minimizes the sum of absolute deviations to the medians.
+ */
+struct MAECriterion {
+    using Accumulator = MedianAccumulator;
+
+    static double cost(const Accumulator& left, const Accumulator& right) {
+        return left.sae() + right.sae();
+    }
+    static double impurity(const Accumulator& all) { return all.sae(); }
+    static double leaf_value(const std::vector<double>& values,
+                             const std::vector<double>* weights = nullptr) {
+        MedianAccumulator all(values, weights);
+        for (size_t k = 0; k < values.size(); ++k) all.add(k);
+        return all.median();
+    }
+};
+
+/**
+ * @brief Running weight, sum of y and sum of y·log(y), for the Poisson deviance.
+ */
+class PoissonAccumulator {
+public:
+    explicit PoissonAccumulator(const std::vector<double>& values,
+                                const std::vector<double>* weights = nullptr)
+        : values(values), weights(weights) {}
+
+    void clear() { n = s = ylogy = 0.0; }
+    void add(int k) { double w = row_weight(weights, k), v = values[k]; n += w; s += w * v; ylogy += w * xlogx(v); }
+    void remove(int k) { double w = row_weight(weights, k), v = values[k]; n -= w; s -= w * v; ylogy -= w * xlogx(v); }
+
+    double count() const { return n; }
+    double mean() const { return s / n; }
+
+    /**
+     * @brief Half Poisson deviance Σ y·log(y / mean), infinite if the mean is not positive.
+     */
+    double deviance() const {
+        if (n == 0.0) return 0.0;
+        if (s <= 0.0) return std::numeric_limits<double>::infinity();
+        return ylogy - s * std::log(s / n);
+    }
+
+private:
+    const std::vector<double>& values;
+    const std::vector<double>* weights;
+    double n = 0.0, s = 0.0, ylogy = 0.0;
+
+    static double xlogx(double v) { return v > 0.0 ? v * std::log(v) : 0.0; }
+};
+
+/**
+ * @brief Poisson deviance, for positive targets such as the measured performance.
+ */
+struct PoissonCriterion {
+    using Accumulator = PoissonAccumulator;
+
+    static double cost(const Accumulator& left, const Accumulator& right) {
+        return left.deviance() + right.deviance();
+    }
+    static double impurity(const Accumulator& all) { return all.deviance(); }
+    static double leaf_value(const std::vector<double>& values,
+                             const std::vector<double>* weights = nullptr) {
+        if (!weights) return mean(values);
+        Accumulator all(values, weights);
+        for (size_t k = 0; k < values.size(); ++k) all.add(k);
+        return all.mean();
+    }
+};
+
+/**
+ * @brief Checks the targets of a Poisson fit, as scikit-learn does: no negative
+ * value and a positive (weighted) sum, else the deviance is undefined.
+ *
+ * @throws std::invalid_argument otherwise.
+ */
+inline void check_poisson_targets(const std::vector<double>& y,
+                                  const std::vector<double>* weights = nullptr)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < y.size(); ++i) {
+        if (y[i] < 0.0)
+            throw std::invalid_argument("Poisson criterion: negative target");
+        sum += row_weight(weights, i) * y[i];
+    }
+    if (!(sum > 0.0))
+        throw std::invalid_argument("Poisson criterion: the targets must have a positive sum");
+}
+
+/**
+ * @brief Cost of a node before any split, for a criterion.
+ */
+template <class Criterion>
+double criterion_impurity(const std::vector<double>& values,
+                          const std::vector<double>* weights = nullptr)
+{
+    typename Criterion::Accumulator all(values, weights);
+    for (size_t k = 0; k < values.size(); ++k) all.add(k);
+    return Criterion::impurity(all);
+}
+
+/**
+ * @brief Exact split search for any criterion.
+ *
+ * For each feature the rows are sorted, then moved one by one from the right
+ * accumulator to the left one, and every threshold between two distinct
+ * values is scored with Criterion::cost().
+ *
+ * @param rows Indices of the rows belonging to the node
+ * @param min_samples_leaf Minimum number of rows in each child
+ * @param features Optional subset of the features to consider (all if nullptr)
+ * @param weights Optional sample weights, indexed like y (all 1 if nullptr)
+ * @return Best split, with its cost in the sse field (feature == -1 if none)
+ */
+template <class Criterion>
+Split find_best_split_with(const std::vector<std::vector<double>>& X,
+                           const std::vector<double>& y,
+                           const std::vector<int>& rows,
+                           int min_samples_leaf = 1,
+                           const std::vector<int>* features = nullptr,
+                           const std::vector<double>* weights = nullptr)
+{
+    Split best;
+    best.sse = std::numeric_limits<double>::max();
+
+    int n = rows.size();
+    if (n < 2) return best;
+    int m = features ? features->size() : X[rows[0]].size();
+    min_samples_leaf = std::max(min_samples_leaf, 1);
+
+    std::vector<double> node_y(n), node_w;
+    for (int k = 0; k < n; ++k) node_y[k] = y[rows[k]];
+    if (weights) {
+        node_w.resize(n);
+        for (int k = 0; k < n; ++k) node_w[k] = (*weights)[rows[k]];
+    }
+
+    typename Criterion::Accumulator left(node_y, weights ? &node_w : nullptr);
+    typename Criterion::Accumulator right(node_y, weights ? &node_w : nullptr);
+    std::vector<int> order(n);
+
+    for (int j = 0; j < m; ++j) {
+        int feature = features ? (*features)[j] : j;
+
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            return X[rows[a]][feature] < X[rows[b]][feature];
+        });
+
+        left.clear();
+        right.clear();
+        for (int k = 0; k < n; ++k) right.add(k);
+
+        for (int i = 0; i < n - 1; ++i) {
+            right.remove(order[i]);
+            left.add(order[i]);
+            if (i + 1 < min_samples_leaf || n - i - 1 < min_samples_leaf)
+                continue;
+
+            double x = X[rows[order[i]]][feature];
+            double next = X[rows[order[i + 1]]][feature];
+            if (!(x < next))
+                continue;
+
+            double cost = Criterion::cost(left, right);
+            if (cost < best.sse) {
+                best.sse = cost;
+                best.feature = feature;
+                best.threshold = (x + next) / 2.0;
+            }
+        }
+    }
+
+    return best;
+}
+
+/**
+ * @brief Scores one given threshold per feature (randomized splits), for any criterion.
+ *
+ * @param features Candidate features
+ * @param thresholds Threshold of each candidate feature
+ * @param weights Optional sample weights, indexed like y (all 1 if nullptr)
+ * @return Best split, with its cost in the sse field (feature == -1 if none)
+ */
+template <class Criterion>
+Split score_thresholds(const std::vector<std::vector<double>>& X,
+                       const std::vector<double>& y,
+                       const std::vector<int>& rows,
+                       const std::vector<int>& features,
+                       const std::vector<double>& thresholds,
+                       const std::vector<double>* weights = nullptr)
+{
+    Split best;
+    best.sse = std::numeric_limits<double>::max();
+
+    int n = rows.size();
+    std::vector<double> node_y(n), node_w;
+    for (int k = 0; k < n; ++k) node_y[k] = y[rows[k]];
+    if (weights) {
+        node_w.resize(n);
+        for (int k = 0; k < n; ++k) node_w[k] = (*weights)[rows[k]];
+    }
+
+    typename Criterion::Accumulator left(node_y, weights ? &node_w : nullptr);
+    typename Criterion::Accumulator right(node_y, weights ? &node_w : nullptr);
+
+    for (size_t j = 0; j < features.size(); ++j) {
+        int feature = features[j];
+        left.clear();
+        right.clear();
+        for (int k = 0; k < n; ++k) {
+            if (X[rows[k]][feature] <= thresholds[j])
+                left.add(k);
+            else
+                right.add(k);
+        }
+        if (left.count() == 0.0 || right.count() == 0.0)
+            continue;
+
+        double cost = Criterion::cost(left, right);
+        if (cost < best.sse) {
+            best.sse = cost;
+            best.feature = feature;
+            best.threshold = thresholds[j];
+        }
+    }
+
+    return best;
+}
+
+#endif
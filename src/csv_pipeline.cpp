@@ -0,0 +1,365 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <queue>
+#include <thread>
+#include "csv_pipeline.hpp"
+
+/**
+ * @brief Blocking FIFO with a maximum size, shared by producer and consumer threads.
+ *
+ * pop() returns false once the queue is closed and empty; push() returns
+ * false (and drops the item) once it is closed, so a closed queue never blocks.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(capacity) {}
+
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_full.wait(lock, [&] { return items.size() < capacity || closed; });
+        if (closed) return false;
+        items.push(std::move(item));
+        not_empty.notify_one();
+        return true;
+    }
+
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_empty.wait(lock, [&] { return !items.empty() || closed; });
+        if (items.empty()) return false;
+        item = std::move(items.front());
+        items.pop();
+        not_full.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+
+private:
+    size_t capacity;
+    bool closed = false;
+    std::queue<T> items;
+    std::mutex mutex;
+    std::condition_variable not_full, not_empty;
+};
+
+/**
+ * @brief Joins a group of threads on every exit path.
+ *
+ * If the threads are still running when the owner leaves (an exception),
+ * stop() is called first so that none of them stays blocked on a queue.
+ */
+class ThreadJoiner {
+public:
+    explicit ThreadJoiner(std::function<void()> stop) : stop(std::move(stop)) {}
+    ~ThreadJoiner() {
+        bool running = std::any_of(threads.begin(), threads.end(),
+                                   [](const std::thread& t) { return t.joinable(); });
+        if (running) stop();
+        join();
+    }
+
+    void join() {
+        for (std::thread& t : threads)
+            if (t.joinable()) t.join();
+    }
+
+    std::vector<std::thread> threads;
+
+private:
+    std::function<void()> stop;
+};
+
+/**
+ * @brief Raw lines of the file, numbered in reading order.
+ *
+ * n_cols: number of columns of the file, fixed by the reader (see column_count()).
+ */
+struct LineBlock {
+    int seq = 0;
+    int n_cols = 0;
+    std::vector<std::string> lines;
+};
+
+/**
+ * @brief Parsed rows of one block.
+ *
+ * values: row-major values (n_rows × n_cols, target in the last column).
+ * runs: for each feature, the block rows sorted by value (local indices).
+ */
+struct RowBlock {
+    int seq = 0;
+    int n_rows = 0;
+    int n_cols = 0;
+    std::vector<double> values;
+    std::vector<std::vector<int>> runs;
+};
+
+/**
+ * @brief Parses one comma-separated line. Lines without numbers (header) give no value.
+ */
+static void parse_line(const std::string& line, std::vector<double>& row)
+{
+    row.clear();
+    const char* p = line.c_str();
+    char* end = nullptr;
+    while (*p) {
+        double v = std::strtod(p, &end);
+        if (end == p) break;
+        row.push_back(v);
+        p = end;
+        while (*p == ',' || *p == ' ' || *p == '\r') ++p;
+    }
+}
+
+/**
+ * @brief Number of columns given by a line: its fields for a header, its
+ * values for a numeric row, 0 for a blank line.
+ */
+static int column_count(const std::string& line)
+{
+    std::vector<double> row;
+    parse_line(line, row);
+    if (!row.empty()) return row.size();
+    if (line.find_first_not_of(" \t\r") == std::string::npos) return 0;
+    return std::count(line.begin(), line.end(), ',') + 1;
+}
+
+/**
+ * @brief Parser thread: turns line blocks into rows and sorts each feature of the block.
+ *
+ * Rows whose number of values differs from the column count of the file are
+ * skipped one by one; the rest of the block is kept.
+ */
+static void parse_blocks(BoundedQueue<LineBlock>& lines, BoundedQueue<RowBlock>& rows)
+{
+    LineBlock in;
+    std::vector<double> row;
+    while (lines.pop(in)) {
+        RowBlock out;
+        out.seq = in.seq;
+        out.n_cols = in.n_cols;
+        for (const std::string& line : in.lines) {
+            parse_line(line, row);
+            if (row.empty()) continue;
+            if ((int)row.size() != out.n_cols) {
+                std::cerr << "Ligne ignorée (mauvais format) : " << line << std::endl;
+                continue;
+            }
+            out.values.insert(out.values.end(), row.begin(), row.end());
+            ++out.n_rows;
+        }
+
+        int m = out.n_cols - 1;
+        out.runs.assign(std::max(m, 0), std::vector<int>(out.n_rows));
+        for (int f = 0; f < m; ++f) {
+            std::vector<int>& run = out.runs[f];
+            std::iota(run.begin(), run.end(), 0);
+            std::stable_sort(run.begin(), run.end(), [&](int a, int b) {
+                return out.values[a * out.n_cols + f] < out.values[b * out.n_cols + f];
+            });
+        }
+        if (!rows.push(std::move(out)))
+            return;
+    }
+}
+
+/**
+ * @brief Loads a CSV file into a Dataset while it is being read.
+ *
+ * A reader thread cuts the file into blocks of lines, parser threads convert
+ * them to numbers and sort every feature of their block, and the calling
+ * thread appends the blocks (in file order) to the columns, updates the
+ * feature ranges and merges the sorted runs like a binary counter. When the
+ * last block arrives only the last few merges remain, so the Dataset is ready
+ * for training right after the file is read. The result is the same as
+ * make_dataset() on the rows of load_csv().
+ *
+ * Only reading, parsing and presorting overlap: training starts once the
+ * Dataset is complete, since an exact split needs every row. An exception in
+ * any thread stops the others; all the threads are joined, then it is rethrown.
+ *
+ * @param filename Path to the CSV file (last column = target).
+ * @param parser_threads Number of parsing threads.
+ * @param block_rows Number of lines per block.
+ * @return Dataset with columns, ranges and sorted row orders.
+ */
+Dataset load_dataset_pipelined(const std::string& filename,
+                               int parser_threads,
+                               int block_rows)
+{
+    Dataset data;
+
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "ERREUR : Impossible d'ouvrir " << filename << std::endl;
+        return data;
+    }
+
+    parser_threads = std::max(parser_threads, 1);
+    BoundedQueue<LineBlock> line_queue(2 * parser_threads);
+    BoundedQueue<RowBlock> row_queue(2 * parser_threads);
+
+    // The first error of any thread closes both queues, which stops the others
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto stop_all = [&](std::exception_ptr e) {
+        {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) error = e;
+        }
+        line_queue.close();
+        row_queue.close();
+    };
+    std::atomic<int> parsing(parser_threads);     // the last parser closes the row queue
+    ThreadJoiner workers([&] { stop_all(nullptr); });
+
+    // The column count is fixed once, by the header or else the first row
+    workers.threads.emplace_back([&] {
+        try {
+            LineBlock block;
+            std::string line;
+            int n_cols = 0;
+            while (std::getline(file, line)) {
+                if (n_cols == 0) {
+                    n_cols = column_count(line);
+                    block.n_cols = n_cols;
+                }
+                block.lines.push_back(std::move(line));
+                if ((int)block.lines.size() == block_rows) {
+                    int seq = block.seq;
+                    if (!line_queue.push(std::move(block)))
+                        return;
+                    block = LineBlock();
+                    block.seq = seq + 1;
+                    block.n_cols = n_cols;
+                }
+            }
+            if (!block.lines.empty())
+                line_queue.push(std::move(block));
+        } catch (...) {
+            stop_all(std::current_exception());
+        }
+        line_queue.close();
+    });
+
+    for (int t = 0; t < parser_threads; ++t) {
+        workers.threads.emplace_back([&] {
+            try {
+                parse_blocks(line_queue, row_queue);
+            } catch (...) {
+                stop_all(std::current_exception());
+            }
+            if (--parsing == 0)
+                row_queue.close();
+        });
+    }
+
+    // Sorted runs waiting to be merged, the oldest first; level = log2 of the blocks merged
+    std::vector<std::vector<std::vector<int>>> runs;
+    std::vector<int> levels;
+    std::vector<std::vector<double>> columns;
+    int m = -1;
+
+    auto merge_top = [&]() {
+        std::vector<std::vector<int>> newer = std::move(runs.back());
+        runs.pop_back();
+        levels.pop_back();
+        std::vector<std::vector<int>>& older = runs.back();
+        for (int f = 0; f < m; ++f) {
+            const std::vector<double>& column = columns[f];
+            std::vector<int> merged(older[f].size() + newer[f].size());
+            std::merge(older[f].begin(), older[f].end(), newer[f].begin(), newer[f].end(),
+                       merged.begin(), [&](int a, int b) { return column[a] < column[b]; });
+            older[f] = std::move(merged);
+        }
+        ++levels.back();
+    };
+
+    auto consume = [&](RowBlock& block) {
+        if (block.n_rows == 0) return;
+        if (m < 0) {
+            m = block.n_cols - 1;
+            columns.assign(m, std::vector<double>());
+            data.feature_min.assign(m, 0.0);
+            data.feature_max.assign(m, 0.0);
+        }
+        if (block.n_cols != m + 1) {
+            std::cerr << "Bloc ignoré (mauvais nombre de colonnes)" << std::endl;
+            return;
+        }
+
+        int offset = data.y.size();
+        for (int i = 0; i < block.n_rows; ++i) {
+            const double* row = &block.values[i * block.n_cols];
+            for (int f = 0; f < m; ++f) {
+                if (offset + i == 0 || row[f] < data.feature_min[f]) data.feature_min[f] = row[f];
+                if (offset + i == 0 || row[f] > data.feature_max[f]) data.feature_max[f] = row[f];
+                columns[f].push_back(row[f]);
+            }
+            data.y.push_back(row[m]);
+        }
+
+        for (std::vector<int>& run : block.runs)
+            for (int& r : run) r += offset;
+        runs.push_back(std::move(block.runs));
+        levels.push_back(0);
+        while (levels.size() >= 2 && levels[levels.size() - 2] == levels.back())
+            merge_top();
+    };
+
+    // Blocks can arrive out of order: keep them until their turn
+    std::map<int, RowBlock> pending;
+    int next_seq = 0;
+    RowBlock block;
+    try {
+        while (row_queue.pop(block)) {
+            pending[block.seq] = std::move(block);
+            for (auto it = pending.find(next_seq); it != pending.end(); it = pending.find(next_seq)) {
+                consume(it->second);
+                pending.erase(it);
+                ++next_seq;
+            }
+        }
+    } catch (...) {
+        stop_all(std::current_exception());
+    }
+
+    workers.join();
+    if (error)
+        std::rethrow_exception(error);
+
+    while (runs.size() >= 2)
+        merge_top();
+
+    // Copy to huge-page buffers from the calling thread: the trainers scan
+    // every column from one thread, so the pages stay on its node
+    m = std::max(m, 0);
+    data.columns.resize(m);
+    data.sorted_rows.resize(m);
+    for (int f = 0; f < m; ++f) {
+        data.columns[f].assign(columns[f].begin(), columns[f].end());
+        std::vector<double>().swap(columns[f]);
+        if (!runs.empty()) {
+            data.sorted_rows[f].assign(runs.back()[f].begin(), runs.back()[f].end());
+            std::vector<int>().swap(runs.back()[f]);
+        }
+    }
+
+    return data;
+}
@@ -0,0 +1,11 @@
+#ifndef CSV_PIPELINE_HPP
+#define CSV_PIPELINE_HPP
+
+#include <string>
+#include "dataset.hpp"
+
+Dataset load_dataset_pipelined(const std::string& filename,
+                               int parser_threads = 2,
+                               int block_rows = 4096);
+
+#endif
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <numeric>
+#include "dataset.hpp"
+
+/**
+ * @brief Builds the column-major dataset and sorts every feature once.
+ *
+ * With the default single thread the columns are filled on the calling
+ * thread, so their pages land on its node, where the trainers (level_wise,
+ * oblivious trees) scan them. More threads sort groups of features in
+ * parallel (see numa_parallel_for()), which only shortens this call: the
+ * columns then sit on the nodes of those threads, not of the scanning one.
+ *
+ * @param X Feature matrix (n samples × m features)
+ * @param y Vector of target values (n values)
+ * @param n_threads Number of threads (0 = one per core, default 1)
+ * @return Dataset with columns and per-feature sorted row orders.
+ */
+Dataset make_dataset(const std::vector<std::vector<double>>& X,
+                     const std::vector<double>& y,
+                     int n_threads)
+{
+    Dataset data;
+    data.y = y;
+
+    int n = X.size();
+    int m = n > 0 ? X[0].size() : 0;
+
+    data.columns.resize(m);
+    data.sorted_rows.resize(m);
+    numa_parallel_for(m, n_threads, [&](int, size_t begin, size_t end) {
+        for (size_t f = begin; f < end; ++f) {
+            Column& column = data.columns[f];
+            column.resize(n);
+            for (int i = 0; i < n; ++i)
+                column[i] = X[i][f];
+
+            RowOrder& order = data.sorted_rows[f];
+            order.resize(n);
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+                return column[a] < column[b];
+            });
+        }
+    });
+
+    data.feature_min.assign(m, 0.0);
+    data.feature_max.assign(m, 0.0);
+    for (int f = 0; f < m && n > 0; ++f) {
+        data.feature_min[f] = data.columns[f][data.sorted_rows[f].front()];
+        data.feature_max[f] = data.columns[f][data.sorted_rows[f].back()];
+    }
+
+    return data;
+}
+
+/**
+ * @brief Dataset made of some rows of another one, without sorting again.
+ *
+ * Row k of the result is row rows[k] of data. Each sorted order of data is
+ * filtered in one pass, so it stays sorted and the subset costs O(n · m)
+ * instead of the O(n log n · m) of make_dataset().
+ *
+ * @param data Source dataset
+ * @param rows Distinct row indices of data
+ */
+Dataset select_rows(const Dataset& data, const std::vector<int>& rows)
+{
+    int n = rows.size();
+    int m = data.features();
+
+    // New index of each row of data (-1: not selected)
+    std::vector<int> position(data.rows(), -1);
+    for (int k = 0; k < n; ++k)
+        position[rows[k]] = k;
+
+    Dataset subset;
+    subset.y.resize(n);
+    for (int k = 0; k < n; ++k)
+        subset.y[k] = data.y[rows[k]];
+
+    subset.columns.resize(m);
+    subset.sorted_rows.resize(m);
+    subset.feature_min.assign(m, 0.0);
+    subset.feature_max.assign(m, 0.0);
+    for (int f = 0; f < m; ++f) {
+        Column& column = subset.columns[f];
+        column.resize(n);
+        for (int k = 0; k < n; ++k)
+            column[k] = data.columns[f][rows[k]];
+
+        RowOrder& order = subset.sorted_rows[f];
+        order.reserve(n);
+        for (int r : data.sorted_rows[f])
+            if (position[r] >= 0)
+                order.push_back(position[r]);
+
+        if (n > 0) {
+            subset.feature_min[f] = column[order.front()];
+            subset.feature_max[f] = column[order.back()];
+        }
+    }
+    return subset;
+}
@@ -0,0 +1,35 @@
+#ifndef DATASET_HPP
+#define DATASET_HPP
+
+#include <vector>
+#include "numa.hpp"
+
+// Column and row-order buffers: huge pages, placed by the thread that fills them
+using Column = std::vector<double, HugePageAllocator<double>>;
+using RowOrder = std::vector<int, HugePageAllocator<int>>;
+
+/**
+ * @brief Column-major copy of a dataset, prepared for training.
+ *
+ * columns: feature values, columns[f][row].
+ * y: target values.
+ * sorted_rows: for each feature, the row indices sorted by increasing value.
+ * feature_min / feature_max: range of each feature.
+ */
+struct Dataset {
+    std::vector<Column> columns;
+    std::vector<double> y;
+    std::vector<RowOrder> sorted_rows;
+    std::vector<double> feature_min;
+    std::vector<double> feature_max;
+
+    int rows() const { return y.size(); }
+    int features() const { return columns.size(); }
+};
+
+Dataset make_dataset(const std::vector<std::vector<double>>& X,
+                     const std::vector<double>& y,
+                     int n_threads = 1);
+Dataset select_rows(const Dataset& data, const std::vector<int>& rows);
+
+#endif
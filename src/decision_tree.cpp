@@ -1,7 +1,15 @@
 #include <iostream>
+#include <iomanip>
+#include <string>
 #include <vector>
 #include <cmath>
 #include <algorithm>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <chrono>
+#include "decision_tree.hpp"
+#include "split_kernel.hpp"
 
 
 /**
@@ -35,47 +43,347 @@ double mse(const std::vector<double>& values) {
     return sum / static_cast<double>(values.size());
 
 }
+
 /**
- * @brief Decision tree node.
- * 
- * is_leaf: true if leaf.
- * samples: number of samples in the node.
- * feature_index: feature used for split (-1 if leaf).
- * threshold: split value.
- * value: predicted value if leaf.
- * left/right: child nodes.
+ * @brief Stores the sufficient statistics of a node (count, Σy, Σy²).
+ * @param node Node to fill.
+ * @param values Target values of the samples in the node.
  */
-struct Node {
-    bool is_leaf = false;
-    int samples = 0;
-    int feature_index = -1;
-    double threshold = 0.0;
-    double value = 0.0;
-
-    Node* left = nullptr;
-    Node* right = nullptr;
-};
+void set_node_stats(Node* node, const std::vector<double>& values) {
+    node->samples = values.size();
+    node->sum = 0.0;
+    node->sum_sq = 0.0;
+    for (double v : values) {
+        node->sum += v;
+        node->sum_sq += v * v;
+    }
+}
+
+/**
+ * @brief Stores the weighted sufficient statistics of a node (Σw, Σwy, Σwy²).
+ * @param node Node to fill.
+ * @param values Target values of the samples in the node.
+ * @param weights Weight of each sample (e.g. number of merged duplicates).
+ */
+void set_node_stats(Node* node, const std::vector<double>& values, const std::vector<double>& weights) {
+    node->samples = 0.0;
+    node->sum = 0.0;
+    node->sum_sq = 0.0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        node->samples += weights[i];
+        node->sum += weights[i] * values[i];
+        node->sum_sq += weights[i] * values[i] * values[i];
+    }
+}
+
+/**
+ * @brief SSE of a node, from its sufficient statistics (count, Σy, Σy²).
+ */
+double node_sse(const Node* node) {
+    if (node->samples == 0) return 0.0;
+    return std::max(0.0, node->sum_sq - node->sum * node->sum / node->samples);
+}
 
 //#define MAX_DEPTH 10
 //#define MIN_SAMPLES 3
 #define MSE_MAX 1e12
 
+#define BOUND_BINS 32
+
+/**
+ * @brief Records the features scanned and pruned by one split search.
+ */
+void SplitStats::record(int depth, int scanned, int pruned) {
+    if (depth >= (int)features_scanned.size()) {
+        features_scanned.resize(depth + 1, 0);
+        features_pruned.resize(depth + 1, 0);
+    }
+    features_scanned[depth] += scanned;
+    features_pruned[depth] += pruned;
+}
+
+/**
+ * @brief Records one approximate split and whether its exact rescoring changed the winner.
+ */
+void SplitStats::record_approx(int depth, bool changed) {
+    if (depth >= (int)approx_nodes.size()) {
+        approx_nodes.resize(depth + 1, 0);
+        approx_changed.resize(depth + 1, 0);
+    }
+    ++approx_nodes[depth];
+    if (changed) ++approx_changed[depth];
+}
+
+/**
+ * @brief Prints the number of features scanned and pruned at each depth.
+ */
+void print_split_stats(const SplitStats& stats) {
+    std::cout << "depth | scanned | pruned\n";
+    for (size_t d = 0; d < stats.features_scanned.size(); ++d) {
+        std::cout << d << " | " << stats.features_scanned[d]
+                  << " | " << stats.features_pruned[d] << "\n";
+    }
+    if (stats.approx_nodes.empty()) return;
+    std::cout << "depth | approximate | winner changed\n";
+    for (size_t d = 0; d < stats.approx_nodes.size(); ++d) {
+        std::cout << d << " | " << stats.approx_nodes[d]
+                  << " | " << stats.approx_changed[d] << "\n";
+    }
+}
+
+/**
+ * @brief Lower bound on the SSE of any split of the rows along one feature.
+ *
+ * The rows are put in BOUND_BINS equal-width bins of the feature range
+ * (one O(n) pass, no sort). A threshold falling inside bin k cannot do better
+ * than SSE(bins before k) + SSE(bins after k), since the SSE of a set is never
+ * smaller than the sum of the SSE of its parts.
+ *
+ * @param c Mean of y over the rows (used to center the sums).
+ * @return Lower bound, or MSE_MAX if the feature is constant on the rows.
+ */
+static double split_lower_bound(const std::vector<std::vector<double>>& X,
+                                const std::vector<double>& y,
+                                const std::vector<int>& rows,
+                                int feature, double c)
+{
+    double lo = X[rows[0]][feature], hi = lo;
+    for (int r : rows) {
+        lo = std::min(lo, X[r][feature]);
+        hi = std::max(hi, X[r][feature]);
+    }
+    if (!(lo < hi)) return MSE_MAX;
+
+    double count[BOUND_BINS] = {0}, sum[BOUND_BINS] = {0}, sum_sq[BOUND_BINS] = {0};
+    double scale = BOUND_BINS / (hi - lo);
+    for (int r : rows) {
+        int b = std::min(BOUND_BINS - 1, (int)((X[r][feature] - lo) * scale));
+        double v = y[r] - c;
+        count[b] += 1.0;
+        sum[b] += v;
+        sum_sq[b] += v * v;
+    }
+
+    // SSE of the bins after k, filled from the right
+    double suffix[BOUND_BINS + 1];
+    double cnt = 0.0, s = 0.0, s2 = 0.0;
+    suffix[BOUND_BINS] = 0.0;
+    for (int b = BOUND_BINS - 1; b >= 0; --b) {
+        cnt += count[b]; s += sum[b]; s2 += sum_sq[b];
+        suffix[b] = cnt > 0.0 ? s2 - s * s / cnt : 0.0;
+    }
+
+    double bound = MSE_MAX;
+    cnt = 0.0; s = 0.0; s2 = 0.0;
+    for (int b = 0; b < BOUND_BINS; ++b) {
+        if (count[b] > 0.0) {
+            double before = cnt > 0.0 ? s2 - s * s / cnt : 0.0;
+            bound = std::min(bound, before + suffix[b + 1]);
+        }
+        cnt += count[b]; s += sum[b]; s2 += sum_sq[b];
+    }
+    return std::max(bound, 0.0);
+}
+
+/**
+ * @brief Finds the split of the given rows that minimizes the weighted MSE.
+ *
+ * A cheap lower bound on the achievable SSE is computed for every feature
+ * (split_lower_bound()) and the features are scanned from the most promising
+ * one. Once the bound of the next feature is above the best SSE found so far,
+ * the remaining features cannot win and are skipped.
+ * For each scanned feature the rows are sorted once, then all thresholds between
+ * consecutive distinct values are scored in a single pass by best_mse_split().
+ *
+ * @param X Feature matrix (n samples × m features)
+ * @param y Vector of target values (n values)
+ * @param rows Indices of the rows belonging to the node
+ * @param min_samples_leaf Minimum number of rows in each child
+ * @param depth Depth of the node (only used for the statistics)
+ * @param stats Optional counters of scanned / pruned features per depth
+ * @param features Optional subset of the features to consider (all if nullptr)
+ * @return Best split (feature == -1 if no feature can separate the rows)
+ */
+Split find_best_split(const std::vector<std::vector<double>>& X,
+                      const std::vector<double>& y,
+                      const std::vector<int>& rows,
+                      int min_samples_leaf,
+                      int depth,
+                      SplitStats* stats,
+                      const std::vector<int>* features)
+{
+    Split best;
+    best.sse = MSE_MAX;
+
+    int n = rows.size();
+    if (n < 2) return best;
+    int m = features ? features->size() : X[rows[0]].size();
+
+    double c = 0.0;
+    for (int r : rows) c += y[r];
+    c /= n;
+
+    double parent_sse = 0.0;
+    for (int r : rows) parent_sse += (y[r] - c) * (y[r] - c);
+
+    // Bound every feature, then visit them from the lowest bound
+    std::vector<double> bound(X[rows[0]].size(), MSE_MAX);
+    std::vector<int> candidates(m);
+    for (int i = 0; i < m; ++i) {
+        int feature = features ? (*features)[i] : i;
+        bound[feature] = split_lower_bound(X, y, rows, feature, c);
+        candidates[i] = feature;
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [&](int a, int b) {
+        return bound[a] < bound[b];
+    });
+
+    // Slack for the rounding differences between the bound and the exact scores
+    double slack = 1e-9 * parent_sse;
+
+    std::vector<int> order(rows);
+    std::vector<double> sorted_x(n), sorted_y(n);
+
+    int scanned = 0;
+    for (int feature : candidates) {
+
+        if (bound[feature] >= MSE_MAX || bound[feature] > best.sse + slack)
+            break;
+        ++scanned;
+
+        // Sort the rows of the node along this feature
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            return X[a][feature] < X[b][feature];
+        });
+        for (int i = 0; i < n; ++i) {
+            sorted_x[i] = X[order[i]][feature];
+            sorted_y[i] = y[order[i]];
+        }
+
+        // Score every threshold between consecutive distinct values
+        SplitScore score = best_mse_split(sorted_x.data(), sorted_y.data(), n, min_samples_leaf);
+        if (score.index < 0)
+            continue;
+
+        // Ties go to the lowest feature index, as with a scan in feature order
+        if (score.sse < best.sse ||
+            (score.sse == best.sse && feature < best.feature)) {
+            best.sse = score.sse;
+            best.feature = feature;
+            best.threshold = (sorted_x[score.index] + sorted_x[score.index + 1]) / 2.0;
+        }
+    }
+
+    if (stats)
+        stats->record(depth, scanned, m - scanned);
+
+    return best;
+}
+
+/**
+ * @brief Split search on a row subsample, for large nodes.
+ *
+ * Nodes with at most approx.min_rows rows use the exact find_best_split().
+ * Above, approx.sample_size rows are drawn uniformly without replacement
+ * and the best split of every feature is scored on them only. The top_k
+ * features (lowest sample SSE) are then scanned exactly on all the rows
+ * and the lowest exact SSE wins. The cost of a node is
+ * O(m · s log s + k · n log n) instead of O(m · n log n).
+ *
+ * The sample depends on approx.seed, the depth and the number of rows, so a
+ * tree is reproducible for a given seed.
+ *
+ * @param stats Optional counters; records whether the exact rescoring
+ *        picked another feature than the sample winner.
+ * @return Exact best split over the top features (feature == -1 if none can separate the rows)
+ */
+Split find_approx_split(const std::vector<std::vector<double>>& X,
+                        const std::vector<double>& y,
+                        const std::vector<int>& rows,
+                        const ApproxSplit& approx,
+                        int min_samples_leaf,
+                        int depth,
+                        SplitStats* stats)
+{
+    int n = rows.size();
+    int s = std::max(approx.sample_size, 2);
+    if (approx.min_rows <= 0 || n <= approx.min_rows || s >= n)
+        return find_best_split(X, y, rows, min_samples_leaf, depth, stats);
+
+    // Uniform sample without replacement (partial Fisher-Yates)
+    std::seed_seq seq{approx.seed, static_cast<unsigned>(depth), static_cast<unsigned>(n)};
+    std::mt19937 rng(seq);
+    std::vector<int> sample(rows);
+    for (int i = 0; i < s; ++i) {
+        std::uniform_int_distribution<int> pick(i, n - 1);
+        std::swap(sample[i], sample[pick(rng)]);
+    }
+    sample.resize(s);
+
+    // Best threshold of every feature on the sample
+    int m = X[rows[0]].size();
+    int sample_leaf = std::max(1, (int)((long)min_samples_leaf * s / n));
+    std::vector<Split> candidates;
+    std::vector<double> sorted_x(s), sorted_y(s);
+    for (int feature = 0; feature < m; ++feature) {
+        std::sort(sample.begin(), sample.end(), [&](int a, int b) {
+            return X[a][feature] < X[b][feature];
+        });
+        for (int i = 0; i < s; ++i) {
+            sorted_x[i] = X[sample[i]][feature];
+            sorted_y[i] = y[sample[i]];
+        }
+
+        SplitScore score = best_mse_split(sorted_x.data(), sorted_y.data(), s, sample_leaf);
+        if (score.index < 0)
+            continue;
+
+        Split candidate;
+        candidate.feature = feature;
+        candidate.sse = score.sse;
+        candidates.push_back(candidate);
+    }
+    if (candidates.empty())
+        return find_best_split(X, y, rows, min_samples_leaf, depth, stats);
+
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Split& a, const Split& b) {
+        return a.sse < b.sse;
+    });
+    candidates.resize(std::min<size_t>(candidates.size(), std::max(approx.top_k, 1)));
+
+    // Exact scan of the top features, on all the rows
+    std::vector<int> top;
+    for (const Split& candidate : candidates)
+        top.push_back(candidate.feature);
+    Split best = find_best_split(X, y, rows, min_samples_leaf, depth, nullptr, &top);
+    if (best.feature == -1)
+        return find_best_split(X, y, rows, min_samples_leaf, depth, stats);
+
+    if (stats)
+        stats->record_approx(depth, best.feature != candidates[0].feature);
+    return best;
+}
+
 /**
  * @brief Recursively builds a regression decision tree.
  * 
  * @param X Feature matrix (n samples × m features)
  * @param y Vector of target values (n values)
  * @param depth Current depth in the tree
+ * @param stats Optional counters of scanned / pruned features per depth
+ * @param approx Optional approximate split search at large nodes (find_approx_split())
  * @return Pointer to the created node (root or subtree)
  */
 Node* build_tree(const std::vector<std::vector<double>>& X,
                  const std::vector<double>& y,
-                 int depth = 0,
-                 int MAX_DEPTH = 10,
-                 int MIN_SAMPLES = 3)
+                 int depth,
+                 int MAX_DEPTH,
+                 int MIN_SAMPLES,
+                 SplitStats* stats,
+                 const ApproxSplit* approx)
 {
     Node* node = new Node();
-    node->samples = y.size();
+    set_node_stats(node, y);
 
     double current_mse = mse(y);
 
@@ -87,54 +395,14 @@ Node* build_tree(const std::vector<std::vector<double>>& X,
     }
 
     int n = X.size();        // number of samples
-    int m = X[0].size();    // number of features
-
-    double best_mse = MSE_MAX;
-    int best_feature = -1;
-    double best_threshold = 0.0;
-
-    for (int feature = 0; feature < m; ++feature) {
-
-         // Collect and sort all values of this feature
-        std::vector<double> sorted_values;
-        sorted_values.reserve(n);
-
-        for (auto &row : X)
-            sorted_values.push_back(row[feature]);
-
-        std::sort(sorted_values.begin(), sorted_values.end());
 
-        // Test thresholds between consecutive values
-        for (int i = 0; i < n - 1; ++i) {
+    std::vector<int> rows(n);
+    std::iota(rows.begin(), rows.end(), 0);
 
-            double threshold = (sorted_values[i] + sorted_values[i+1]) / 2.0;
-
-            std::vector<double> left_y, right_y;
-             
-
-            // Split target values according to threshold
-            for (int k = 0; k < n; ++k) {
-                if (X[k][feature] <= threshold)
-                    left_y.push_back(y[k]);
-                else
-                    right_y.push_back(y[k]);
-            }
-
-            if (left_y.empty() || right_y.empty())
-                continue;
-            
-            // Compute weighted MSE for this split
-            double mse_split =
-                (left_y.size() * mse(left_y) +
-                 right_y.size() * mse(right_y)) / n;
-
-            if (mse_split < best_mse) {
-                best_mse = mse_split;
-                best_feature = feature;
-                best_threshold = threshold;
-            }
-        }
-    }
+    Split split = approx ? find_approx_split(X, y, rows, *approx, 1, depth, stats)
+                         : find_best_split(X, y, rows, 1, depth, stats);
+    int best_feature = split.feature;
+    double best_threshold = split.threshold;
 
     if (best_feature == -1) {
         node->is_leaf = true;
@@ -158,13 +426,193 @@ Node* build_tree(const std::vector<std::vector<double>>& X,
         }
     }
 
-    node->left = build_tree(X_left, y_left, depth + 1);
-    node->right = build_tree(X_right, y_right, depth + 1);
+    node->left = build_tree(X_left, y_left, depth + 1, MAX_DEPTH, MIN_SAMPLES, stats, approx);
+    node->right = build_tree(X_right, y_right, depth + 1, MAX_DEPTH, MIN_SAMPLES, stats, approx);
 
     return node;
 }
 
 
+/**
+ * @brief Node of the best-first frontier, waiting to be split.
+ */
+struct FrontierNode {
+    Node* node;
+    std::vector<int> rows;
+    int depth;
+    Split split;
+    double gain;
+};
+
+/**
+ * @brief Builds a regression decision tree best-first.
+ *
+ * Instead of recursing depth-first, the leaves that can still be split are
+ * kept in a priority queue ordered by the SSE reduction of their best split,
+ * and the most useful one is always expanded first. Growth stops when no leaf
+ * can be split, when max_leaf_nodes is reached or when the time budget is
+ * spent, so the returned tree is always the best one found within the budget.
+ * Without leaf or time limit the result is the same tree as build_tree().
+ *
+ * @param X Feature matrix (n samples × m features)
+ * @param y Vector of target values (n values)
+ * @param limits Depth, size and time limits of the growth
+ * @param stats Optional counters of scanned / pruned features per depth
+ * @return Pointer to the root of the tree
+ */
+Node* build_tree_best_first(const std::vector<std::vector<double>>& X,
+                            const std::vector<double>& y,
+                            const GrowthLimits& limits,
+                            SplitStats* stats)
+{
+    using clock = std::chrono::steady_clock;
+    clock::time_point deadline = clock::now() +
+        std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(limits.time_budget));
+
+    std::vector<FrontierNode> frontier;
+
+    // Largest gain first, the oldest node first on ties
+    auto lower_priority = [&](int a, int b) {
+        if (frontier[a].gain != frontier[b].gain)
+            return frontier[a].gain < frontier[b].gain;
+        return a > b;
+    };
+    std::priority_queue<int, std::vector<int>, decltype(lower_priority)> queue(lower_priority);
+
+    // Creates a leaf and, if it can be split, adds it to the frontier
+    auto make_leaf = [&](std::vector<int> rows, int depth) {
+        Node* node = new Node();
+        node->is_leaf = true;
+
+        std::vector<double> node_y;
+        node_y.reserve(rows.size());
+        for (int r : rows) node_y.push_back(y[r]);
+        set_node_stats(node, node_y);
+        node->value = mean(node_y);
+
+        double current_mse = mse(node_y);
+        if (depth >= limits.max_depth || (int)rows.size() <= limits.min_samples || current_mse < 1e-6)
+            return node;
+
+        Split split = find_best_split(X, y, rows, limits.min_samples_leaf, depth, stats);
+        if (split.feature == -1)
+            return node;
+
+        double gain = current_mse * rows.size() - split.sse;
+        frontier.push_back({node, std::move(rows), depth, split, gain});
+        queue.push(frontier.size() - 1);
+        return node;
+    };
+
+    std::vector<int> rows(X.size());
+    std::iota(rows.begin(), rows.end(), 0);
+    Node* root = make_leaf(std::move(rows), 0);
+    int leaves = 1;
+
+    while (!queue.empty()) {
+        if (limits.max_leaf_nodes > 0 && leaves >= limits.max_leaf_nodes)
+            break;
+        if (limits.time_budget > 0.0 && clock::now() >= deadline)
+            break;
+
+        int id = queue.top();
+        queue.pop();
+
+        // make_leaf() grows the frontier, so copy what is needed first
+        Node* node = frontier[id].node;
+        Split split = frontier[id].split;
+        int depth = frontier[id].depth;
+        std::vector<int> node_rows = std::move(frontier[id].rows);
+
+        std::vector<int> left_rows, right_rows;
+        for (int r : node_rows) {
+            if (X[r][split.feature] <= split.threshold)
+                left_rows.push_back(r);
+            else
+                right_rows.push_back(r);
+        }
+
+        node->is_leaf = false;
+        node->feature_index = split.feature;
+        node->threshold = split.threshold;
+        node->left = make_leaf(std::move(left_rows), depth + 1);
+        node->right = make_leaf(std::move(right_rows), depth + 1);
+        ++leaves;
+    }
+
+    return root;
+}
+
+/**
+ * @brief Counts the leaves of a tree.
+ */
+int count_leaves(const Node* node) {
+    if (node->is_leaf)
+        return 1;
+    return count_leaves(node->left) + count_leaves(node->right);
+}
+
+/**
+ * @brief Releases a tree and all its subtrees.
+ */
+void free_tree(Node* node) {
+    if (!node) return;
+    free_tree(node->left);
+    free_tree(node->right);
+    delete node;
+}
+
+/**
+ * @brief Writes a tree as text, one node per line in preorder.
+ *
+ * Leaf: "L value samples sum sum_sq".
+ * Internal node: "N feature threshold value samples sum sum_sq", followed by
+ * its left then right subtree. Values are written with 17 digits so that a
+ * loaded tree predicts exactly the same values.
+ */
+void save_tree(const Node* node, std::ostream& out) {
+    out << std::setprecision(17);
+    if (node->is_leaf) {
+        out << "L " << node->value << " " << node->samples << " "
+            << node->sum << " " << node->sum_sq << "\n";
+        return;
+    }
+    out << "N " << node->feature_index << " " << node->threshold << " " << node->value << " "
+        << node->samples << " " << node->sum << " " << node->sum_sq << "\n";
+    save_tree(node->left, out);
+    save_tree(node->right, out);
+}
+
+/**
+ * @brief Reads a tree written by save_tree().
+ * @return Root of the tree, or nullptr if the input is truncated or malformed.
+ */
+Node* load_tree(std::istream& in) {
+    std::string kind;
+    if (!(in >> kind) || (kind != "L" && kind != "N"))
+        return nullptr;
+
+    Node* node = new Node();
+    node->is_leaf = kind == "L";
+    if (!node->is_leaf)
+        in >> node->feature_index >> node->threshold;
+    in >> node->value >> node->samples >> node->sum >> node->sum_sq;
+    if (!in) {
+        delete node;
+        return nullptr;
+    }
+
+    if (!node->is_leaf) {
+        node->left = load_tree(in);
+        node->right = node->left ? load_tree(in) : nullptr;
+        if (!node->right) {
+            free_tree(node);
+            return nullptr;
+        }
+    }
+    return node;
+}
+
 /**
  * @brief Predicts a value for a sample by traversing the tree.
  * 
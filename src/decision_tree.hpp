@@ -2,10 +2,26 @@
 #define DECISION_TREE_HPP
 
 #include <vector>
+#include <iosfwd>
 
+/**
+ * @brief Decision tree node.
+ * 
+ * is_leaf: true if leaf.
+ * samples: number of samples in the node (total sample weight for weighted rows).
+ * sum / sum_sq: sum of y and of y² over the samples of the node.
+ * new_samples: samples added by update() since the split was last checked.
+ * feature_index: feature used for split (-1 if leaf).
+ * threshold: split value.
+ * value: predicted value if leaf.
+ * left/right: child nodes.
+ */
 struct Node {
     bool is_leaf = false;
-    int samples = 0;
+    double samples = 0.0;
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    int new_samples = 0;
     int feature_index = -1;
     double threshold = 0.0;
     double value = 0.0;
@@ -14,13 +30,103 @@ struct Node {
     Node* right = nullptr;
 };
 
+/**
+ * @brief Best split found for a node.
+ *
+ * feature: feature used for the split (-1 if no valid split).
+ * threshold: rows with X[feature] <= threshold go to the left child.
+ * sse: sum of squared errors of the two children.
+ */
+struct Split {
+    int feature = -1;
+    double threshold = 0.0;
+    double sse = 0.0;
+};
+
+/**
+ * @brief Split search counters, indexed by depth.
+ *
+ * features_scanned: features whose thresholds were all scored.
+ * features_pruned: features skipped because their bound could not win.
+ * approx_nodes: nodes split on a row subsample (find_approx_split()).
+ * approx_changed: of those, nodes where the exact rescoring changed the winner.
+ */
+struct SplitStats {
+    std::vector<long> features_scanned;
+    std::vector<long> features_pruned;
+    std::vector<long> approx_nodes;
+    std::vector<long> approx_changed;
+
+    void record(int depth, int scanned, int pruned);
+    void record_approx(int depth, bool changed);
+};
+
+/**
+ * @brief Approximate split search at large nodes (find_approx_split()).
+ *
+ * min_rows: nodes with more rows are split approximately (0 = never).
+ * sample_size: rows drawn uniformly, without replacement, to score the candidates.
+ * top_k: best candidates (one per feature) rescored exactly on all the rows.
+ * seed: seed of the row sampling.
+ */
+struct ApproxSplit {
+    int min_rows = 0;
+    int sample_size = 2048;
+    int top_k = 3;
+    unsigned seed = 42;
+};
+
+/**
+ * @brief Limits of the best-first growth (build_tree_best_first()).
+ *
+ * max_depth / min_samples: same meaning as MAX_DEPTH / MIN_SAMPLES.
+ * min_samples_leaf: minimum number of samples in each child of a split.
+ * max_leaf_nodes: maximum number of leaves (0 = no limit).
+ * time_budget: training time limit in seconds (0 = no limit).
+ */
+struct GrowthLimits {
+    int max_depth = 10;
+    int min_samples = 3;
+    int min_samples_leaf = 1;
+    int max_leaf_nodes = 0;
+    double time_budget = 0.0;
+};
+
 double mean(const std::vector<double>& values);
 double mse(const std::vector<double>& values);
+void set_node_stats(Node* node, const std::vector<double>& values);
+void set_node_stats(Node* node, const std::vector<double>& values, const std::vector<double>& weights);
+double node_sse(const Node* node);
+Split find_best_split(const std::vector<std::vector<double>>& X,
+                      const std::vector<double>& y,
+                      const std::vector<int>& rows,
+                      int min_samples_leaf = 1,
+                      int depth = 0,
+                      SplitStats* stats = nullptr,
+                      const std::vector<int>* features = nullptr);
+Split find_approx_split(const std::vector<std::vector<double>>& X,
+                        const std::vector<double>& y,
+                        const std::vector<int>& rows,
+                        const ApproxSplit& approx,
+                        int min_samples_leaf = 1,
+                        int depth = 0,
+                        SplitStats* stats = nullptr);
 Node* build_tree(const std::vector<std::vector<double>>& X,
                  const std::vector<double>& y,
                  int depth = 0,
                  int MAX_DEPTH = 10,
-                 int MIN_SAMPLES = 3);
+                 int MIN_SAMPLES = 3,
+                 SplitStats* stats = nullptr,
+                 const ApproxSplit* approx = nullptr);
+Node* build_tree_best_first(const std::vector<std::vector<double>>& X,
+                            const std::vector<double>& y,
+                            const GrowthLimits& limits,
+                            SplitStats* stats = nullptr);
+int count_leaves(const Node* node);
+void free_tree(Node* node);
+void save_tree(const Node* node, std::ostream& out);
+Node* load_tree(std::istream& in);
+void print_split_stats(const SplitStats& stats);
 double predict(Node* node, const std::vector<double>& sample);
 
 #endif
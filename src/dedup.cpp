@@ -0,0 +1,55 @@
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include "dedup.hpp"
+
+/**
+ * @brief FNV-1a hash of a feature vector (0.0 and -0.0 hash the same, as they compare equal).
+ */
+struct RowHash {
+    size_t operator()(const std::vector<double>& row) const {
+        uint64_t h = 1469598103934665603ULL;
+        for (double v : row) {
+            if (v == 0.0) v = 0.0;
+            uint64_t bits;
+            std::memcpy(&bits, &v, sizeof(bits));
+            for (int b = 0; b < 8; ++b) {
+                h ^= (bits >> (8 * b)) & 0xFF;
+                h *= 1099511628211ULL;
+            }
+        }
+        return h;
+    }
+};
+
+std::vector<double> WeightedRows::mean() const
+{
+    std::vector<double> values(X.size());
+    for (size_t i = 0; i < X.size(); ++i)
+        values[i] = sum[i] / count[i];
+    return values;
+}
+
+WeightedRows deduplicate(const std::vector<std::vector<double>>& X,
+                         const std::vector<double>& y)
+{
+    WeightedRows rows;
+    std::unordered_map<std::vector<double>, int, RowHash> index;
+    index.reserve(X.size());
+
+    for (size_t i = 0; i < X.size(); ++i) {
+        auto found = index.emplace(X[i], rows.X.size());
+        int r = found.first->second;
+        if (found.second) {
+            rows.X.push_back(X[i]);
+            rows.count.push_back(0.0);
+            rows.sum.push_back(0.0);
+            rows.sum_sq.push_back(0.0);
+        }
+        rows.count[r] += 1.0;
+        rows.sum[r] += y[i];
+        rows.sum_sq[r] += y[i] * y[i];
+    }
+
+    return rows;
+}
@@ -0,0 +1,37 @@
+#ifndef DEDUP_HPP
+#define DEDUP_HPP
+
+#include <vector>
+
+/**
+ * @brief Distinct feature vectors of a dataset, each one standing for all its duplicates.
+ *
+ * X: distinct rows, in order of first appearance.
+ * count: number of rows merged into each distinct row (its sample weight).
+ * sum / sum_sq: Σy and Σy² over the merged rows.
+ */
+struct WeightedRows {
+    std::vector<std::vector<double>> X;
+    std::vector<double> count;
+    std::vector<double> sum;
+    std::vector<double> sum_sq;
+
+    int rows() const { return X.size(); }
+    std::vector<double> mean() const;
+};
+
+/**
+ * @brief Merges the rows that have exactly the same feature vector.
+ *
+ * Repeated measurements of one configuration become a single weighted row.
+ * Training on the result (DecisionTreeRegressor::fit(const WeightedRows&))
+ * gives the same splits and leaf values as training on X, y.
+ *
+ * @param X Feature matrix
+ * @param y Target vector
+ * @return Distinct rows with their count, Σy and Σy²
+ */
+WeightedRows deduplicate(const std::vector<std::vector<double>>& X,
+                         const std::vector<double>& y);
+
+#endif
@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "distributed.hpp"
+
+// Bytes of histograms built and reduced at once: the open nodes of a level
+// are processed in batches that fit, instead of all together
+static const size_t HIST_BUDGET = size_t(256) << 20;
+
+/**
+ * @brief In-place MPI_SUM of a buffer of any length, in pieces of at most INT_MAX doubles.
+ */
+static void allreduce_sum(double* data, size_t count, MPI_Comm comm)
+{
+    while (count > 0) {
+        int piece = static_cast<int>(std::min<size_t>(count, INT_MAX));
+        MPI_Allreduce(MPI_IN_PLACE, data, piece, MPI_DOUBLE, MPI_SUM, comm);
+        data += piece;
+        count -= piece;
+    }
+}
+
+/**
+ * @brief Node of the current level in the distributed builder.
+ *
+ * count / sum / sum_sq: global number of rows, sums of (y - c) and (y - c)²
+ * where c is the global mean of y, identical on every rank.
+ * slot: index of the node histograms in the level buffer (-1 for a leaf).
+ */
+struct BinnedNode {
+    Node* node = nullptr;
+    double count = 0.0, sum = 0.0, sum_sq = 0.0;
+    int slot = -1;
+};
+
+/**
+ * @brief Fills the statistics of a tree node from centered global sums.
+ */
+static void set_binned_stats(Node* node, const BinnedNode& b, double c)
+{
+    node->samples = b.count;
+    node->sum = b.sum + b.count * c;
+    node->sum_sq = b.sum_sq + 2.0 * c * b.sum + b.count * c * c;
+    node->value = c + b.sum / b.count;
+}
+
+/**
+ * @brief Builds a regression tree one level at a time on rows spread over the ranks.
+ *
+ * The global range of each feature is allreduced once and cut into n_bins
+ * equal-width bins, and every local value is replaced by its bin. Then, for
+ * each depth, each rank accumulates the (count, Σy, Σy²) histograms of its
+ * rows for every open node and feature, an MPI_Allreduce sums them, and the
+ * best bin boundary of each node is taken from the global histograms. The
+ * open nodes go by batches whose histograms fit in HIST_BUDGET (at least one
+ * node per batch). Only histograms travel between ranks, never rows.
+ *
+ * All ranks compute the same decisions; they are still broadcast from rank 0
+ * (a few doubles per node) so that the trees stay bit-identical even if the
+ * reduction rounds differently on some rank. A bin b holds the values in
+ * (edge[b-1], edge[b]], so the split "x <= edge[b]" used by predict() sends
+ * exactly the rows of bins 0..b to the left child.
+ */
+Node* build_tree_distributed(const std::vector<std::vector<double>>& X,
+                             const std::vector<double>& y,
+                             MPI_Comm comm,
+                             int MAX_DEPTH,
+                             int MIN_SAMPLES,
+                             int n_bins,
+                             SplitStats* stats)
+{
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    int n = X.size();
+    int local_m = n > 0 ? X[0].size() : 0;
+    int m;
+    MPI_Allreduce(&local_m, &m, 1, MPI_INT, MPI_MAX, comm);
+    n_bins = std::max(2, std::min(n_bins, 65536));
+
+    // Global size and mean of y, used to center the sums
+    double totals[2] = {static_cast<double>(n), 0.0};
+    for (double v : y) totals[1] += v;
+    MPI_Allreduce(MPI_IN_PLACE, totals, 2, MPI_DOUBLE, MPI_SUM, comm);
+
+    Node* root = new Node();
+    if (totals[0] == 0.0) {
+        root->is_leaf = true;
+        return root;
+    }
+    double c = totals[1] / totals[0];
+
+    // Global range of every feature, then equal-width bin edges
+    std::vector<double> lo(m, std::numeric_limits<double>::infinity());
+    std::vector<double> hi(m, -std::numeric_limits<double>::infinity());
+    for (int r = 0; r < n; ++r) {
+        for (int f = 0; f < m; ++f) {
+            lo[f] = std::min(lo[f], X[r][f]);
+            hi[f] = std::max(hi[f], X[r][f]);
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, lo.data(), m, MPI_DOUBLE, MPI_MIN, comm);
+    MPI_Allreduce(MPI_IN_PLACE, hi.data(), m, MPI_DOUBLE, MPI_MAX, comm);
+
+    std::vector<std::vector<double>> edges(m);
+    for (int f = 0; f < m; ++f) {
+        if (!(lo[f] < hi[f])) continue;
+        double width = (hi[f] - lo[f]) / n_bins;
+        for (int b = 1; b < n_bins; ++b)
+            edges[f].push_back(lo[f] + b * width);
+    }
+
+    std::vector<uint16_t> bins(static_cast<size_t>(n) * m);
+    for (int r = 0; r < n; ++r) {
+        for (int f = 0; f < m; ++f) {
+            const std::vector<double>& e = edges[f];
+            bins[static_cast<size_t>(r) * m + f] = std::lower_bound(e.begin(), e.end(), X[r][f]) - e.begin();
+        }
+    }
+
+    // Root statistics
+    BinnedNode first;
+    first.node = root;
+    first.count = totals[0];
+    for (int r = 0; r < n; ++r) {
+        double v = y[r] - c;
+        first.sum += v;
+        first.sum_sq += v * v;
+    }
+    double root_sums[2] = {first.sum, first.sum_sq};
+    MPI_Allreduce(MPI_IN_PLACE, root_sums, 2, MPI_DOUBLE, MPI_SUM, comm);
+    first.sum = root_sums[0];
+    first.sum_sq = root_sums[1];
+
+    std::vector<int> node_of(n, 0);      // level node of each local row, -1 once in a leaf
+    std::vector<BinnedNode> level{first};
+    std::vector<double> hist;
+
+    for (int depth = 0; !level.empty(); ++depth) {
+
+        // Stop conditions: max depth, few samples, or very small variance
+        int open = 0;
+        for (BinnedNode& b : level) {
+            set_binned_stats(b.node, b, c);
+            double mean = b.sum / b.count;
+            double current_mse = b.sum_sq / b.count - mean * mean;
+            if (depth >= MAX_DEPTH || b.count <= MIN_SAMPLES || current_mse < 1e-6)
+                b.node->is_leaf = true;
+            else
+                b.slot = open++;
+        }
+        if (open == 0)
+            break;
+
+        // Histograms of one node, checked before anything is allocated (same on every rank)
+        size_t node_size = static_cast<size_t>(m) * n_bins * 3;
+        if (node_size > hist.max_size())
+            throw std::length_error("build_tree_distributed: histograms too large");
+        size_t batch = std::max<size_t>(1, HIST_BUDGET / sizeof(double) / std::max<size_t>(node_size, 1));
+
+        std::vector<double> decisions(open * 5, -1.0);
+        for (int first_slot = 0; first_slot < open; first_slot += batch) {
+            int end_slot = std::min<size_t>(open, first_slot + batch);
+
+            // Local histograms of the open nodes of the batch, summed over the ranks
+            hist.assign((end_slot - first_slot) * node_size, 0.0);
+            for (int r = 0; r < n; ++r) {
+                int s = node_of[r];
+                if (s < 0 || level[s].slot < first_slot || level[s].slot >= end_slot) continue;
+                double v = y[r] - c;
+                double* h = hist.data() + (level[s].slot - first_slot) * node_size;
+                const uint16_t* row_bins = bins.data() + static_cast<size_t>(r) * m;
+                for (int f = 0; f < m; ++f) {
+                    double* cell = h + (static_cast<size_t>(f) * n_bins + row_bins[f]) * 3;
+                    cell[0] += 1.0;
+                    cell[1] += v;
+                    cell[2] += v * v;
+                }
+            }
+            allreduce_sum(hist.data(), hist.size(), comm);
+
+            // Best bin boundary of each open node: feature, bin, left count / sum / sum_sq
+            for (const BinnedNode& b : level) {
+                if (b.slot < first_slot || b.slot >= end_slot) continue;
+                double best_sse = std::numeric_limits<double>::max();
+                double* d = decisions.data() + b.slot * 5;
+                const double* h = hist.data() + (b.slot - first_slot) * node_size;
+
+                for (int f = 0; f < m; ++f) {
+                    double lc = 0.0, ls = 0.0, lsq = 0.0;
+                    for (int k = 0; k + 1 < n_bins; ++k) {
+                        const double* cell = h + (static_cast<size_t>(f) * n_bins + k) * 3;
+                        lc += cell[0];
+                        ls += cell[1];
+                        lsq += cell[2];
+                        double rc = b.count - lc;
+                        if (cell[0] == 0.0 || lc == 0.0 || rc <= 0.0) continue;
+
+                        double rs = b.sum - ls, rsq = b.sum_sq - lsq;
+                        double sse = (lsq - ls * ls / lc) + (rsq - rs * rs / rc);
+                        if (sse < best_sse) {
+                            best_sse = sse;
+                            d[0] = f;
+                            d[1] = k;
+                            d[2] = lc;
+                            d[3] = ls;
+                            d[4] = lsq;
+                        }
+                    }
+                }
+            }
+        }
+        MPI_Bcast(decisions.data(), decisions.size(), MPI_DOUBLE, 0, comm);
+
+        // Split the open nodes and create the next level
+        std::vector<BinnedNode> next;
+        std::vector<int> first_child(level.size(), -1);
+        for (size_t s = 0; s < level.size(); ++s) {
+            BinnedNode& b = level[s];
+            if (b.slot < 0) continue;
+            const double* d = decisions.data() + b.slot * 5;
+            if (d[0] < 0.0) {
+                b.node->is_leaf = true;
+                continue;
+            }
+            int f = d[0], k = d[1];
+            b.node->feature_index = f;
+            b.node->threshold = edges[f][k];
+            b.node->left = new Node();
+            b.node->right = new Node();
+
+            first_child[s] = next.size();
+            BinnedNode left, right;
+            left.node = b.node->left;
+            left.count = d[2];
+            left.sum = d[3];
+            left.sum_sq = d[4];
+            right.node = b.node->right;
+            right.count = b.count - d[2];
+            right.sum = b.sum - d[3];
+            right.sum_sq = b.sum_sq - d[4];
+            next.push_back(left);
+            next.push_back(right);
+        }
+
+        // Move every local row to its child
+        for (int r = 0; r < n; ++r) {
+            int s = node_of[r];
+            if (s < 0) continue;
+            if (first_child[s] < 0) {
+                node_of[r] = -1;
+                continue;
+            }
+            const double* d = decisions.data() + level[s].slot * 5;
+            int f = d[0], k = d[1];
+            node_of[r] = first_child[s] + (bins[static_cast<size_t>(r) * m + f] <= k ? 0 : 1);
+        }
+
+        if (stats && rank == 0)
+            stats->record(depth, open * m, 0);
+
+        level = std::move(next);
+    }
+
+    return root;
+}
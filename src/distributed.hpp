@@ -0,0 +1,30 @@
+#ifndef DISTRIBUTED_HPP
+#define DISTRIBUTED_HPP
+
+#include <mpi.h>
+#include <vector>
+#include "decision_tree.hpp"
+
+/**
+ * @brief Builds a regression tree on rows partitioned over the ranks of comm.
+ *
+ * Collective: every rank passes its own shard of rows and gets the same tree.
+ *
+ * @param X Local feature matrix (rows of this rank)
+ * @param y Local target vector
+ * @param comm Communicator of the ranks sharing the dataset
+ * @param MAX_DEPTH Maximum depth of the tree
+ * @param MIN_SAMPLES Nodes with at most MIN_SAMPLES rows (over all ranks) become leaves
+ * @param n_bins Number of equal-width bins per feature (at most 65536)
+ * @param stats Optional counters of scanned features per depth
+ * @return Pointer to the root of the tree, owned by the caller
+ */
+Node* build_tree_distributed(const std::vector<std::vector<double>>& X,
+                             const std::vector<double>& y,
+                             MPI_Comm comm,
+                             int MAX_DEPTH = 10,
+                             int MIN_SAMPLES = 3,
+                             int n_bins = 256,
+                             SplitStats* stats = nullptr);
+
+#endif
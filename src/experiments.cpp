@@ -0,0 +1,572 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "csv_pipeline.hpp"
+#include "decision_tree.hpp"
+#include "level_wise.hpp"
+#include "DecisionTreeRegressor.hpp"
+#include "BaggingRegressor.hpp"
+#include "oblivious_tree.hpp"
+#include "oblivious_scorer.hpp"
+#include "model_cache.hpp"
+
+/*
+ * Experiment runner: trains every model of a config on every dataset.
+ *
+ *   ./experiments config.conf [results.csv]
+ *
+ * Config lines (# starts a comment, paths are relative to the config file):
+ *   dataset <path.csv>                      one line per dataset
+ *   model <kind> <key>=<v1>,<v2>,...        one job per combination of values
+ *   test_fraction <f>                       held-out rows (default 0.2)
+ *   seed <n>                                seed of the train/test split (default 0)
+ *   threads <n>                             worker threads (default 0 = all cores)
+ *   output <results.csv>                    results table (default results.csv)
+ *   cache <directory> | off                 trained trees (default: ModelCache::default_directory())
+ *
+ * Model kinds and their parameters:
+ *   build_tree  max_depth min_samples approx_min_rows approx_sample approx_top_k
+ *   level_wise  max_depth min_samples
+ *   oblivious   depth
+ *   best_first  max_depth min_samples min_samples_leaf max_leaf_nodes
+ *   regressor   max_depth min_samples_split min_gain criterion splitter max_features seed
+ *   bagging     n_estimators + the regressor parameters (trees trained on the job's thread)
+ *
+ * Each dataset is loaded and split once, then all the jobs run on a shared
+ * pool of threads and the results are written as one table. The trees of a
+ * job are looked up in the model cache first, keyed on the dataset content,
+ * the kind, the parameters and the train/test split; a job served from the
+ * cache is marked as such and its fit_seconds is 0. Oblivious trees are
+ * always trained, and scored with ObliviousScorer. predict_seconds is the
+ * time taken to predict the test rows.
+ */
+
+using Params = std::map<std::string, std::string>;
+
+/**
+ * @brief Dataset loaded once and shared (read-only) by all the jobs.
+ */
+struct PreparedDataset {
+    std::string path;
+    std::string name;
+    std::vector<std::vector<double>> X_train, X_test;
+    std::vector<double> y_train, y_test;
+    Dataset train_columns;      // column-major training rows for level_wise
+};
+
+struct ModelSpec {
+    std::string kind;
+    std::vector<std::pair<std::string, std::vector<std::string>>> grid;
+};
+
+struct Config {
+    std::vector<std::string> datasets;
+    std::vector<ModelSpec> models;
+    double test_fraction = 0.2;
+    unsigned seed = 0;
+    int threads = 0;
+    std::string output = "results.csv";
+    std::string cache = ModelCache::default_directory();   // empty: no cache
+};
+
+struct Job {
+    int dataset;
+    std::string kind;
+    Params params;
+};
+
+struct Result {
+    bool cached = false;
+    double fit_seconds = 0.0;
+    double predict_seconds = 0.0;
+    int leaves = 0;
+    double test_rmse = 0.0;
+    double test_r2 = 0.0;
+    std::string error;
+};
+
+static const std::map<std::string, std::vector<std::string>> MODEL_PARAMS = {
+    {"build_tree", {"max_depth", "min_samples", "approx_min_rows", "approx_sample", "approx_top_k"}},
+    {"level_wise", {"max_depth", "min_samples"}},
+    {"oblivious", {"depth"}},
+    {"best_first", {"max_depth", "min_samples", "min_samples_leaf", "max_leaf_nodes"}},
+    {"regressor", {"max_depth", "min_samples_split", "min_gain", "criterion", "splitter",
+                   "max_features", "seed"}},
+    {"bagging", {"n_estimators", "max_depth", "min_samples_split", "min_gain", "criterion",
+                 "splitter", "max_features", "seed"}},
+};
+
+static std::vector<std::string> split_list(const std::string& text, char sep)
+{
+    std::vector<std::string> items;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, sep))
+        if (!item.empty()) items.push_back(item);
+    return items;
+}
+
+/**
+ * @brief Reads a config file (see the top of this file). Throws on errors.
+ */
+static Config read_config(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error("cannot open config " + path);
+
+    std::string base;
+    size_t slash = path.find_last_of('/');
+    if (slash != std::string::npos) base = path.substr(0, slash + 1);
+    auto resolve = [&](const std::string& p) { return p.empty() || p[0] == '/' ? p : base + p; };
+
+    Config config;
+    std::string line;
+    for (int number = 1; std::getline(file, line); ++number) {
+        line = line.substr(0, line.find('#'));
+        std::stringstream ss(line);
+        std::string key;
+        if (!(ss >> key)) continue;
+
+        auto error = [&](const std::string& message) {
+            return std::runtime_error(path + ":" + std::to_string(number) + ": " + message);
+        };
+
+        if (key == "dataset") {
+            std::string p;
+            if (!(ss >> p)) throw error("missing dataset path");
+            config.datasets.push_back(resolve(p));
+        } else if (key == "model") {
+            ModelSpec spec;
+            if (!(ss >> spec.kind) || !MODEL_PARAMS.count(spec.kind))
+                throw error("unknown model kind '" + spec.kind + "'");
+            const std::vector<std::string>& allowed = MODEL_PARAMS.at(spec.kind);
+            std::string assignment;
+            while (ss >> assignment) {
+                size_t eq = assignment.find('=');
+                std::string name = assignment.substr(0, eq);
+                if (eq == std::string::npos || std::find(allowed.begin(), allowed.end(), name) == allowed.end())
+                    throw error("invalid parameter '" + assignment + "' for " + spec.kind);
+                std::vector<std::string> values = split_list(assignment.substr(eq + 1), ',');
+                if (values.empty()) throw error("no value for " + name);
+                spec.grid.emplace_back(name, values);
+            }
+            config.models.push_back(spec);
+        } else if (key == "test_fraction") {
+            if (!(ss >> config.test_fraction) || config.test_fraction < 0.0 || config.test_fraction >= 1.0)
+                throw error("test_fraction must be in [0, 1)");
+        } else if (key == "seed") {
+            if (!(ss >> config.seed)) throw error("invalid seed");
+        } else if (key == "threads") {
+            if (!(ss >> config.threads)) throw error("invalid thread count");
+        } else if (key == "output") {
+            if (!(ss >> config.output)) throw error("missing output path");
+        } else if (key == "cache") {
+            if (!(ss >> config.cache)) throw error("missing cache directory (or off)");
+            config.cache = config.cache == "off" ? "" : resolve(config.cache);
+        } else {
+            throw error("unknown key '" + key + "'");
+        }
+    }
+
+    if (config.datasets.empty() || config.models.empty())
+        throw std::runtime_error(path + ": at least one dataset and one model are needed");
+    return config;
+}
+
+/**
+ * @brief One job per dataset and per combination of parameter values (cartesian product).
+ */
+static std::vector<Job> expand_jobs(const Config& config)
+{
+    std::vector<Job> jobs;
+    for (size_t d = 0; d < config.datasets.size(); ++d) {
+        for (const ModelSpec& spec : config.models) {
+            std::vector<size_t> pick(spec.grid.size(), 0);
+            while (true) {
+                Job job{static_cast<int>(d), spec.kind, {}};
+                for (size_t p = 0; p < spec.grid.size(); ++p)
+                    job.params[spec.grid[p].first] = spec.grid[p].second[pick[p]];
+                jobs.push_back(job);
+
+                size_t p = 0;
+                while (p < pick.size() && ++pick[p] == spec.grid[p].second.size())
+                    pick[p++] = 0;
+                if (p == pick.size()) break;
+            }
+        }
+    }
+    return jobs;
+}
+
+/**
+ * @brief Loads a CSV once, shuffles its rows and splits them into train and test sets.
+ *
+ * The training columns are taken from the loaded Dataset with select_rows(),
+ * so the features are sorted only once, by the loader.
+ */
+static PreparedDataset prepare_dataset(const std::string& path, double test_fraction, unsigned seed)
+{
+    Dataset data = load_dataset_pipelined(path);
+    if (data.rows() == 0)
+        throw std::runtime_error("empty or missing dataset " + path);
+
+    std::vector<int> order(data.rows());
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937 rng(seed);
+    std::shuffle(order.begin(), order.end(), rng);
+    int n_test = static_cast<int>(test_fraction * data.rows());
+
+    PreparedDataset prepared;
+    prepared.path = path;
+    prepared.name = path.substr(path.find_last_of('/') + 1);
+    for (int k = 0; k < data.rows(); ++k) {
+        int r = order[k];
+        std::vector<double> row(data.features());
+        for (int f = 0; f < data.features(); ++f)
+            row[f] = data.columns[f][r];
+        if (k < n_test) {
+            prepared.X_test.push_back(row);
+            prepared.y_test.push_back(data.y[r]);
+        } else {
+            prepared.X_train.push_back(row);
+            prepared.y_train.push_back(data.y[r]);
+        }
+    }
+    std::vector<int> train_rows(order.begin() + n_test, order.end());
+    prepared.train_columns = select_rows(data, train_rows);
+    return prepared;
+}
+
+static int param(const Params& params, const std::string& name, int fallback)
+{
+    auto it = params.find(name);
+    return it == params.end() ? fallback : std::stoi(it->second);
+}
+
+static double param(const Params& params, const std::string& name, double fallback)
+{
+    auto it = params.find(name);
+    return it == params.end() ? fallback : std::stod(it->second);
+}
+
+static std::string param(const Params& params, const std::string& name, const std::string& fallback)
+{
+    auto it = params.find(name);
+    return it == params.end() ? fallback : it->second;
+}
+
+/**
+ * @brief Sets the tree parameters shared by DecisionTreeRegressor and BaggingRegressor.
+ */
+template <class Model>
+static void set_tree_params(Model& model, const Params& p)
+{
+    model.max_depth = param(p, "max_depth", model.max_depth);
+    model.min_samples_split = param(p, "min_samples_split", model.min_samples_split);
+    model.min_gain = param(p, "min_gain", model.min_gain);
+    model.max_features = param(p, "max_features", model.max_features);
+    model.seed = param(p, "seed", static_cast<int>(model.seed));
+
+    std::string splitter = param(p, "splitter", "best");
+    if (splitter != "best" && splitter != "random")
+        throw std::invalid_argument("unknown splitter " + splitter);
+    model.splitter = splitter == "random" ? SplitStrategy::Random : SplitStrategy::Best;
+
+    static const std::map<std::string, SplitCriterion> criteria = {
+        {"mse", SplitCriterion::MSE}, {"friedman_mse", SplitCriterion::FriedmanMSE},
+        {"mae", SplitCriterion::MAE}, {"poisson", SplitCriterion::Poisson}};
+    std::string criterion = param(p, "criterion", "mse");
+    if (!criteria.count(criterion))
+        throw std::invalid_argument("unknown criterion " + criterion);
+    model.criterion = criteria.at(criterion);
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Test RMSE and R² of the predictions of the test rows.
+ */
+static void score(const std::vector<double>& predictions, const PreparedDataset& data, Result& result)
+{
+    double sse = 0.0, mean_y = 0.0, sst = 0.0;
+    for (double v : data.y_test) mean_y += v;
+    mean_y /= std::max<size_t>(1, data.y_test.size());
+    for (size_t i = 0; i < data.y_test.size(); ++i) {
+        double e = predictions[i] - data.y_test[i];
+        sse += e * e;
+        sst += (data.y_test[i] - mean_y) * (data.y_test[i] - mean_y);
+    }
+    size_t n = std::max<size_t>(1, data.y_test.size());
+    result.test_rmse = std::sqrt(sse / n);
+    result.test_r2 = sst > 0.0 ? 1.0 - sse / sst : 0.0;
+}
+
+/**
+ * @brief Timed test predictions of a Node model (mean of its trees), its scores and number of leaves.
+ */
+static void evaluate(const std::vector<Node*>& trees, const PreparedDataset& data, Result& result)
+{
+    std::vector<double> predictions(data.X_test.size());
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < data.X_test.size(); ++i) {
+        double p = 0.0;
+        for (Node* tree : trees) p += predict(tree, data.X_test[i]);
+        predictions[i] = p / std::max<size_t>(1, trees.size());
+    }
+    result.predict_seconds = seconds_since(start);
+
+    score(predictions, data, result);
+    result.leaves = 0;
+    for (Node* tree : trees) result.leaves += count_leaves(tree);
+}
+
+/**
+ * @brief Same for an oblivious tree, predicted by the SIMD kernels of ObliviousScorer.
+ */
+static void evaluate(const ObliviousTree& tree, const PreparedDataset& data, Result& result)
+{
+    ObliviousScorer scorer({tree});
+    std::vector<double> predictions;
+    auto start = std::chrono::steady_clock::now();
+    scorer.predict_batch(data.X_test, predictions);
+    result.predict_seconds = seconds_since(start);
+
+    score(predictions, data, result);
+    result.leaves = tree.leaf_values.size();
+}
+
+static std::string describe(const Params& params)
+{
+    std::string text;
+    for (const auto& kv : params)
+        text += (text.empty() ? "" : " ") + kv.first + "=" + kv.second;
+    return text;
+}
+
+/**
+ * @brief Trains the Node trees of a job (every kind but oblivious). The caller owns them.
+ */
+static std::vector<Node*> train_trees(const Job& job, const PreparedDataset& data)
+{
+    const Params& p = job.params;
+
+    if (job.kind == "regressor") {
+        DecisionTreeRegressor tree;
+        set_tree_params(tree, p);
+        tree.fit(data.X_train, data.y_train);
+        Node* root = tree.root;
+        tree.root = nullptr;
+        return {root};
+    }
+
+    if (job.kind == "bagging") {
+        BaggingRegressor bagging;
+        set_tree_params(bagging, p);
+        bagging.n_estimators = param(p, "n_estimators", bagging.n_estimators);
+        bagging.n_threads = 1;      // the jobs already share the thread pool
+        bagging.fit(data.X_train, data.y_train);
+        std::vector<Node*> roots;
+        for (auto& tree : bagging.trees) {
+            roots.push_back(tree->root);
+            tree->root = nullptr;
+        }
+        return roots;
+    }
+
+    int max_depth = param(p, "max_depth", 10);
+    int min_samples = param(p, "min_samples", 3);
+    if (job.kind == "build_tree") {
+        ApproxSplit approx;
+        approx.min_rows = param(p, "approx_min_rows", approx.min_rows);
+        approx.sample_size = param(p, "approx_sample", approx.sample_size);
+        approx.top_k = param(p, "approx_top_k", approx.top_k);
+        return {build_tree(data.X_train, data.y_train, 0, max_depth, min_samples, nullptr,
+                           approx.min_rows > 0 ? &approx : nullptr)};
+    }
+    if (job.kind == "level_wise")
+        return {build_tree_level_wise(data.train_columns, max_depth, min_samples)};
+
+    GrowthLimits limits;
+    limits.max_depth = max_depth;
+    limits.min_samples = min_samples;
+    limits.min_samples_leaf = param(p, "min_samples_leaf", limits.min_samples_leaf);
+    limits.max_leaf_nodes = param(p, "max_leaf_nodes", limits.max_leaf_nodes);
+    return {build_tree_best_first(data.X_train, data.y_train, limits)};
+}
+
+/**
+ * @brief Trains (or loads from the cache) and evaluates one model. Errors are reported in the result.
+ *
+ * @param split Description of the train/test split, part of the cache keys
+ * @param cache Model cache, nullptr to always train
+ */
+static Result run_job(const Job& job, const PreparedDataset& data,
+                      const std::string& split, const ModelCache* cache)
+{
+    Result result;
+    std::vector<Node*> trees;
+    try {
+        auto start = std::chrono::steady_clock::now();
+        const Params& p = job.params;
+
+        if (job.kind == "oblivious") {
+            ObliviousTree oblivious = build_oblivious_tree(data.train_columns, param(p, "depth", 6));
+            result.fit_seconds = seconds_since(start);
+            evaluate(oblivious, data, result);
+            return result;
+        }
+
+        // One cache entry per tree: a bagging job is served only if all its trees are there
+        int n_trees = job.kind == "bagging" ? param(p, "n_estimators", BaggingRegressor().n_estimators) : 1;
+        std::string description = job.kind + " " + describe(p) + " " + split;
+        std::vector<std::string> keys;
+        if (cache) {
+            std::string key = model_key(data.path, description);
+            for (int t = 0; t < n_trees; ++t)
+                keys.push_back(n_trees == 1 ? key : key + "_" + std::to_string(t));
+            for (const std::string& key : keys) {
+                Node* tree = cache->load(key);
+                if (!tree) break;
+                trees.push_back(tree);
+            }
+            if ((int)trees.size() == n_trees && n_trees > 0) {
+                result.cached = true;
+            } else {
+                for (Node* tree : trees) free_tree(tree);
+                trees.clear();
+            }
+        }
+
+        if (!result.cached) {
+            trees = train_trees(job, data);
+            result.fit_seconds = seconds_since(start);
+            if (cache && trees.size() == keys.size())
+                for (size_t t = 0; t < trees.size(); ++t)
+                    cache->store(keys[t], trees[t]);
+        }
+        evaluate(trees, data, result);
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+    for (Node* tree : trees) free_tree(tree);
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " config.conf [results.csv]\n";
+        return 1;
+    }
+
+    Config config;
+    std::vector<Job> jobs;
+    try {
+        config = read_config(argv[1]);
+        if (argc > 2) config.output = argv[2];
+        jobs = expand_jobs(config);
+    } catch (const std::exception& e) {
+        std::cerr << "Erreur : " << e.what() << "\n";
+        return 1;
+    }
+
+    // Every dataset is parsed and split exactly once
+    auto start = std::chrono::steady_clock::now();
+    std::vector<PreparedDataset> datasets;
+    try {
+        for (const std::string& path : config.datasets) {
+            datasets.push_back(prepare_dataset(path, config.test_fraction, config.seed));
+            std::cout << "Dataset " << datasets.back().name << " : "
+                      << datasets.back().X_train.size() << " train / "
+                      << datasets.back().X_test.size() << " test rows\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Erreur : " << e.what() << "\n";
+        return 1;
+    }
+
+    // Trained trees of previous runs, keyed on the split as well as the job
+    std::unique_ptr<ModelCache> cache;
+    if (!config.cache.empty())
+        cache.reset(new ModelCache(config.cache));
+    std::ostringstream split;
+    split << "test_fraction=" << config.test_fraction << " seed=" << config.seed;
+
+    // Shared pool: each worker takes the next job until none is left
+    int threads = config.threads > 0 ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min<int>(threads, jobs.size());
+    std::vector<Result> results(jobs.size());
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&]() {
+            for (size_t j = next++; j < jobs.size(); j = next++)
+                results[j] = run_job(jobs[j], datasets[jobs[j].dataset], split.str(), cache.get());
+        });
+    }
+    for (std::thread& worker : pool)
+        worker.join();
+    double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ofstream out(config.output);
+    if (!out) {
+        std::cerr << "Erreur : cannot write " << config.output << "\n";
+        return 1;
+    }
+    out << "dataset,model,params,cached,fit_seconds,predict_seconds,leaves,test_rmse,test_r2,error\n";
+    out << std::setprecision(10);
+    size_t width = 8;
+    for (const Job& job : jobs)
+        width = std::max(width, describe(job.params).size() + 2);
+    std::cout << "\n" << std::left << std::setw(22) << "dataset" << std::setw(12) << "model"
+              << std::setw(width) << "params" << std::right << std::setw(10) << "fit (s)"
+              << std::setw(10) << "pred (s)"
+              << std::setw(8) << "leaves" << std::setw(12) << "RMSE" << std::setw(9) << "R2" << "\n";
+
+    int failed = 0;
+    for (size_t j = 0; j < jobs.size(); ++j) {
+        const Job& job = jobs[j];
+        const Result& r = results[j];
+        const std::string& name = datasets[job.dataset].name;
+        out << name << "," << job.kind << "," << describe(job.params) << "," << r.cached << ","
+            << r.fit_seconds << "," << r.predict_seconds << "," << r.leaves << "," << r.test_rmse << "," << r.test_r2 << ","
+            << "\"" << r.error << "\"\n";
+
+        std::cout << std::left << std::setw(22) << name << std::setw(12) << job.kind
+                  << std::setw(width) << describe(job.params) << std::right;
+        if (!r.error.empty()) {
+            std::cout << "  error: " << r.error << "\n";
+            ++failed;
+            continue;
+        }
+        if (r.cached)
+            std::cout << std::setw(10) << "cached";
+        else
+            std::cout << std::fixed << std::setprecision(3) << std::setw(10) << r.fit_seconds;
+        std::cout << std::fixed << std::setprecision(3) << std::setw(10) << r.predict_seconds
+                  << std::setw(8) << r.leaves << std::setprecision(5) << std::setw(12) << r.test_rmse
+                  << std::setprecision(4) << std::setw(9) << r.test_r2 << "\n";
+        std::cout.unsetf(std::ios::floatfield);
+    }
+
+    std::cout << "\n" << jobs.size() << " jobs on " << threads << " threads in " << total
+              << " s, results written to " << config.output << "\n";
+    return failed == 0 ? 0 : 2;
+}
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <thread>
+#include "importance.hpp"
+
+static void add_gains(const Node* node, std::vector<double>& gains)
+{
+    if (node->is_leaf) return;
+    gains[node->feature_index] += node_sse(node) - node_sse(node->left) - node_sse(node->right);
+    add_gains(node->left, gains);
+    add_gains(node->right, gains);
+}
+
+/**
+ * @brief Split-gain importance: SSE reduction brought by each feature, normalized to 1.
+ *
+ * Uses the statistics stored in the nodes during training, so no data pass is needed.
+ *
+ * @param root Root of the tree.
+ * @param n_features Number of features of the training data.
+ */
+std::vector<double> split_gain_importance(const Node* root, int n_features)
+{
+    std::vector<double> gains(n_features, 0.0);
+    add_gains(root, gains);
+
+    double total = std::accumulate(gains.begin(), gains.end(), 0.0);
+    if (total > 0.0)
+        for (double& g : gains) g /= total;
+    return gains;
+}
+
+/**
+ * @brief Prediction of row i when feature f is read from row shuffled[i] instead.
+ */
+static double predict_shuffled(const Node* node,
+                               const std::vector<std::vector<double>>& X,
+                               int i, int f, int shuffled)
+{
+    while (!node->is_leaf) {
+        int r = node->feature_index == f ? shuffled : i;
+        node = X[r][node->feature_index] <= node->threshold ? node->left : node->right;
+    }
+    return node->value;
+}
+
+/**
+ * @brief Permutation importance of every feature.
+ *
+ * Each (feature, repeat) pair is an independent job: the feature column is
+ * shuffled by a permutation of the row indices (a view, the data is never
+ * copied) and the whole dataset is predicted again. Jobs are shared by
+ * n_threads threads; each job seeds its own generator from seed and its
+ * index, so the result does not depend on the number of threads.
+ *
+ * @param root Root of the trained tree.
+ * @param n_repeats Number of shuffles per feature.
+ * @param n_threads Number of threads (0 = one per core).
+ */
+PermutationImportance permutation_importance(const Node* root,
+                                             const std::vector<std::vector<double>>& X,
+                                             const std::vector<double>& y,
+                                             int n_repeats,
+                                             unsigned seed,
+                                             int n_threads)
+{
+    PermutationImportance result;
+    int n = X.size();
+    if (n == 0) return result;
+    int m = X[0].size();
+
+    for (int i = 0; i < n; ++i) {
+        double d = predict_shuffled(root, X, i, -1, i) - y[i];
+        result.baseline_mse += d * d;
+    }
+    result.baseline_mse /= n;
+
+    int jobs = m * n_repeats;
+    std::vector<double> increase(jobs, 0.0);
+    std::atomic<int> next_job(0);
+
+    auto worker = [&]() {
+        std::vector<int> perm(n);
+        for (int job = next_job++; job < jobs; job = next_job++) {
+            int f = job / n_repeats;
+            std::iota(perm.begin(), perm.end(), 0);
+            std::shuffle(perm.begin(), perm.end(), std::mt19937(seed + 7919u * job));
+
+            double error = 0.0;
+            for (int i = 0; i < n; ++i) {
+                double d = predict_shuffled(root, X, i, f, perm[i]) - y[i];
+                error += d * d;
+            }
+            increase[job] = error / n - result.baseline_mse;
+        }
+    };
+
+    if (n_threads <= 0)
+        n_threads = std::max(1u, std::thread::hardware_concurrency());
+    n_threads = std::min(n_threads, jobs);
+    std::vector<std::thread> threads;
+    for (int t = 1; t < n_threads; ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread& t : threads)
+        t.join();
+
+    result.mean.assign(m, 0.0);
+    result.stddev.assign(m, 0.0);
+    for (int f = 0; f < m; ++f) {
+        for (int r = 0; r < n_repeats; ++r)
+            result.mean[f] += increase[f * n_repeats + r] / n_repeats;
+        for (int r = 0; r < n_repeats; ++r) {
+            double d = increase[f * n_repeats + r] - result.mean[f];
+            result.stddev[f] += d * d / n_repeats;
+        }
+        result.stddev[f] = std::sqrt(result.stddev[f]);
+    }
+    return result;
+}
@@ -0,0 +1,27 @@
+#ifndef IMPORTANCE_HPP
+#define IMPORTANCE_HPP
+
+#include <vector>
+#include "decision_tree.hpp"
+
+/**
+ * @brief Permutation importance of each feature.
+ *
+ * mean / stddev: increase of the MSE when the feature is shuffled, over the repeats.
+ * baseline_mse: MSE of the model on the unshuffled data.
+ */
+struct PermutationImportance {
+    std::vector<double> mean;
+    std::vector<double> stddev;
+    double baseline_mse = 0.0;
+};
+
+std::vector<double> split_gain_importance(const Node* root, int n_features);
+PermutationImportance permutation_importance(const Node* root,
+                                             const std::vector<std::vector<double>>& X,
+                                             const std::vector<double>& y,
+                                             int n_repeats = 5,
+                                             unsigned seed = 0,
+                                             int n_threads = 0);
+
+#endif
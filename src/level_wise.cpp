@@ -0,0 +1,191 @@
+#include <cstddef>
+#include <vector>
+#include "level_wise.hpp"
+
+#define MSE_MAX 1e12
+
+/**
+ * @brief Node of the current level, with its statistics and split search state.
+ *
+ * count / sum / sum_sq: number of rows, sum of y and of y², then c = mean of y.
+ * total / total_sq: sums of (y - c) and (y - c)² over the rows.
+ * left_*: rows already seen by the current feature pass (left child).
+ * last: last feature value seen by the current feature pass.
+ */
+struct LevelNode {
+    Node* node = nullptr;
+    bool open = false;
+
+    double count = 0.0, sum = 0.0, sum_sq = 0.0, c = 0.0;
+    double total = 0.0, total_sq = 0.0;
+
+    double left_count = 0.0, left_sum = 0.0, left_sq = 0.0;
+    double last = 0.0;
+
+    Split best;
+};
+
+/**
+ * @brief Builds a regression decision tree one level at a time.
+ *
+ * Every row knows the frontier node it belongs to (node_of). For each depth,
+ * the split search makes one streaming pass per feature over the rows sorted
+ * once in the Dataset, and accumulates the prefix sums of all frontier nodes
+ * at the same time. The rows are then moved to their children with one more
+ * pass, so no row or feature vector is ever copied or re-sorted.
+ * The tree has the same stop conditions and splits as build_tree().
+ *
+ * @param data Column-major dataset with sorted row orders (make_dataset())
+ * @param MAX_DEPTH Maximum depth of the tree
+ * @param MIN_SAMPLES Nodes with at most MIN_SAMPLES rows become leaves
+ * @param stats Optional counters of scanned features per depth
+ * @return Pointer to the root of the tree
+ */
+Node* build_tree_level_wise(const Dataset& data,
+                            int MAX_DEPTH,
+                            int MIN_SAMPLES,
+                            SplitStats* stats)
+{
+    int n = data.rows();
+    int m = data.features();
+
+    Node* root = new Node();
+    if (n == 0) {
+        root->is_leaf = true;
+        return root;
+    }
+
+    // Feature values and targets in sorted order, read sequentially at each depth
+    std::vector<Column> sorted_x(m, Column(n));
+    std::vector<Column> sorted_y(m, Column(n));
+    for (int f = 0; f < m; ++f) {
+        for (int i = 0; i < n; ++i) {
+            int r = data.sorted_rows[f][i];
+            sorted_x[f][i] = data.columns[f][r];
+            sorted_y[f][i] = data.y[r];
+        }
+    }
+
+    std::vector<int> node_of(n, 0);      // frontier node of each row, -1 once in a leaf
+    std::vector<LevelNode> level(1);
+    level[0].node = root;
+
+    for (int depth = 0; !level.empty(); ++depth) {
+
+        // Size, mean and variance of every frontier node
+        for (int r = 0; r < n; ++r) {
+            int s = node_of[r];
+            if (s < 0) continue;
+            level[s].count += 1.0;
+            level[s].sum += data.y[r];
+            level[s].sum_sq += data.y[r] * data.y[r];
+        }
+        for (LevelNode& l : level)
+            l.c = l.sum / l.count;
+        for (int r = 0; r < n; ++r) {
+            int s = node_of[r];
+            if (s < 0) continue;
+            double d = data.y[r] - level[s].c;
+            level[s].total += d;
+            level[s].total_sq += d * d;
+        }
+
+        // Stop conditions: max depth, few samples, or very small variance
+        int open = 0;
+        for (LevelNode& l : level) {
+            l.node->samples = l.count;
+            l.node->sum = l.sum;
+            l.node->sum_sq = l.sum_sq;
+            l.node->value = l.c;
+            double current_mse = l.total_sq / l.count;
+            if (depth >= MAX_DEPTH || l.count <= MIN_SAMPLES || current_mse < 1e-6) {
+                l.node->is_leaf = true;
+            } else {
+                l.open = true;
+                l.best.sse = MSE_MAX;
+                ++open;
+            }
+        }
+        if (open == 0)
+            break;
+
+        // One pass per feature scores the thresholds of all open nodes
+        for (int f = 0; f < m; ++f) {
+            for (LevelNode& l : level) {
+                l.left_count = 0.0;
+                l.left_sum = 0.0;
+                l.left_sq = 0.0;
+            }
+
+            const RowOrder& order = data.sorted_rows[f];
+            for (int i = 0; i < n; ++i) {
+                int s = node_of[order[i]];
+                if (s < 0 || !level[s].open) continue;
+
+                LevelNode& l = level[s];
+                double v = sorted_x[f][i];
+
+                // Threshold between the previous value of the node and this one
+                if (l.left_count > 0.0 && l.last < v) {
+                    double nr = l.count - l.left_count;
+                    double right = l.total - l.left_sum;
+                    double right_sq = l.total_sq - l.left_sq;
+                    double sse = (l.left_sq - l.left_sum * l.left_sum / l.left_count) +
+                                 (right_sq - right * right / nr);
+                    if (sse < l.best.sse) {
+                        l.best.sse = sse;
+                        l.best.feature = f;
+                        l.best.threshold = (l.last + v) / 2.0;
+                    }
+                }
+
+                double d = sorted_y[f][i] - l.c;
+                l.left_count += 1.0;
+                l.left_sum += d;
+                l.left_sq += d * d;
+                l.last = v;
+            }
+        }
+
+        // Split the open nodes and create the next level
+        std::vector<LevelNode> next;
+        std::vector<int> first_child(level.size(), -1);
+        for (size_t s = 0; s < level.size(); ++s) {
+            LevelNode& l = level[s];
+            if (!l.open) continue;
+            if (l.best.feature == -1) {
+                l.node->is_leaf = true;
+                continue;
+            }
+            l.node->feature_index = l.best.feature;
+            l.node->threshold = l.best.threshold;
+            l.node->left = new Node();
+            l.node->right = new Node();
+
+            first_child[s] = next.size();
+            next.emplace_back();
+            next.back().node = l.node->left;
+            next.emplace_back();
+            next.back().node = l.node->right;
+        }
+
+        // Move every row to its child
+        for (int r = 0; r < n; ++r) {
+            int s = node_of[r];
+            if (s < 0) continue;
+            if (first_child[s] < 0) {
+                node_of[r] = -1;
+                continue;
+            }
+            const Split& split = level[s].best;
+            node_of[r] = first_child[s] + (data.columns[split.feature][r] <= split.threshold ? 0 : 1);
+        }
+
+        if (stats)
+            stats->record(depth, open * m, 0);
+
+        level = std::move(next);
+    }
+
+    return root;
+}
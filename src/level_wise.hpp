@@ -0,0 +1,12 @@
+#ifndef LEVEL_WISE_HPP
+#define LEVEL_WISE_HPP
+
+#include "dataset.hpp"
+#include "decision_tree.hpp"
+
+Node* build_tree_level_wise(const Dataset& data,
+                            int MAX_DEPTH = 10,
+                            int MIN_SAMPLES = 3,
+                            SplitStats* stats = nullptr);
+
+#endif
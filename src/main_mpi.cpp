@@ -0,0 +1,115 @@
+#include <mpi.h>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "decision_tree.hpp"
+#include "distributed.hpp"
+
+/**
+ * @brief Loads the rows of a CSV file that belong to one rank.
+ *
+ * Data rows are dealt round-robin: rank r keeps rows r, r + size, r + 2·size...
+ * The other rows are parsed by no one else on this rank, so the memory of the
+ * dataset is split between the ranks. The last column is the target.
+ * Every rank reads the width of the first data row; rows of another width
+ * are skipped, so all the kept rows have the same number of features.
+ */
+void load_csv_shard(const std::string& filename, int rank, int size,
+                    std::vector<std::vector<double>>& X,
+                    std::vector<double>& y)
+{
+    std::ifstream file(filename);
+    std::string line;
+    long row_index = 0;
+    size_t width = 0;
+
+    auto parse = [](const std::string& text) {
+        std::stringstream ss(text);
+        std::vector<double> row;
+        double value;
+        while (ss >> value) {
+            row.push_back(value);
+            if (ss.peek() == ',') ss.ignore();
+        }
+        return row;
+    };
+
+    while (std::getline(file, line)) {
+        unsigned char first = line.empty() ? 0 : line[0];
+        if (!(std::isdigit(first) || first == '-' || first == '.'))
+            continue;    // header or blank line
+        if (width == 0)
+            width = parse(line).size();
+        if (row_index++ % size != rank)
+            continue;
+
+        std::vector<double> row = parse(line);
+        if (row.size() != width) {
+            std::cerr << "Ligne ignorée (mauvais nombre de colonnes) : " << line << std::endl;
+            continue;
+        }
+
+        y.push_back(row.back());
+        row.pop_back();
+        X.push_back(row);
+    }
+}
+
+/**
+ * @brief Data-parallel training:
+ * mpirun -np N ./main_mpi [dataset.csv] [max_depth] [min_samples] [bins] [model_out]
+ */
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    std::string dataset = argc > 1 ? argv[1] : "../datasets/15k_ga_adaptive.csv";
+    int max_depth = argc > 2 ? std::stoi(argv[2]) : 10;
+    int min_samples = argc > 3 ? std::stoi(argv[3]) : 3;
+    int bins = argc > 4 ? std::stoi(argv[4]) : 256;
+
+    std::vector<std::vector<double>> X;
+    std::vector<double> y;
+    load_csv_shard(dataset, rank, size, X, y);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start = MPI_Wtime();
+    SplitStats stats;
+    Node* tree = build_tree_distributed(X, y, MPI_COMM_WORLD, max_depth, min_samples, bins, &stats);
+    double elapsed = MPI_Wtime() - start;
+
+    // Training error over all shards
+    double local[2] = {0.0, static_cast<double>(y.size())};
+    for (size_t i = 0; i < X.size(); ++i) {
+        double e = predict(tree, X[i]) - y[i];
+        local[0] += e * e;
+    }
+    double global[2];
+    MPI_Reduce(local, global, 2, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        std::cout << "Ranks: " << size << ", rows: " << static_cast<long>(global[1])
+                  << ", bins: " << bins << "\n";
+        std::cout << "Training time: " << elapsed << " s\n";
+        std::cout << "Leaves: " << count_leaves(tree) << "\n";
+        std::cout << "Train RMSE: " << std::sqrt(global[0] / global[1]) << "\n";
+        print_split_stats(stats);
+
+        if (argc > 5) {
+            std::ofstream out(argv[5]);
+            save_tree(tree, out);
+            std::cout << "Model saved to " << argv[5] << "\n";
+        }
+    }
+
+    free_tree(tree);
+    MPI_Finalize();
+    return 0;
+}
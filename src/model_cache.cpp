@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "model_cache.hpp"
+
+namespace fs = std::filesystem;
+
+// Bump when the training code or the tree format changes, to invalidate old entries
+#define MODEL_CACHE_VERSION 2
+
+static const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+static uint64_t fnv1a(const char* data, size_t size, uint64_t hash = FNV_OFFSET)
+{
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief 64-bit FNV-1a hash of the content of a file (0 if it cannot be read).
+ */
+uint64_t hash_file(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return 0;
+
+    uint64_t hash = FNV_OFFSET;
+    std::vector<char> buffer(1 << 16);
+    while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0)
+        hash = fnv1a(buffer.data(), file.gcount(), hash);
+    return hash;
+}
+
+/**
+ * @brief Cache key of a model trained on a CSV file.
+ *
+ * The key covers the dataset content (which includes the header, hence the
+ * column layout), its number of columns and the training parameters.
+ *
+ * @param dataset Path to the CSV file.
+ * @param params Every parameter of the training, e.g. "build_tree max_depth=10 min_samples=3".
+ * @return 16-character hexadecimal key.
+ */
+std::string model_key(const std::string& dataset, const std::string& params)
+{
+    std::string header;
+    std::ifstream file(dataset);
+    std::getline(file, header);
+    size_t columns = std::count(header.begin(), header.end(), ',') + 1;
+
+    std::ostringstream description;
+    description << "v" << MODEL_CACHE_VERSION << ";" << std::hex << hash_file(dataset)
+                << ";" << std::dec << columns << ";" << params;
+    std::string text = description.str();
+
+    std::ostringstream key;
+    key << std::hex;
+    key.width(16);
+    key.fill('0');
+    key << fnv1a(text.data(), text.size());
+    return key.str();
+}
+
+/**
+ * @brief Cache directory: $PPN_MODEL_CACHE, or .ppn_cache in the working directory.
+ */
+std::string ModelCache::default_directory()
+{
+    const char* env = std::getenv("PPN_MODEL_CACHE");
+    return env && *env ? env : ".ppn_cache";
+}
+
+ModelCache::ModelCache(const std::string& directory, uintmax_t max_bytes)
+    : directory(directory), max_bytes(max_bytes)
+{
+}
+
+/**
+ * @brief Loads the tree stored under key.
+ * @return Tree, or nullptr if the key is not in the cache.
+ */
+Node* ModelCache::load(const std::string& key) const
+{
+    fs::path path = fs::path(directory) / (key + ".tree");
+    std::ifstream file(path);
+    if (!file.is_open())
+        return nullptr;
+
+    Node* tree = load_tree(file);
+    if (tree) {
+        std::error_code ec;
+        fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    }
+    return tree;
+}
+
+/**
+ * @brief Stores a tree under key (atomic rename), then evicts old entries.
+ */
+void ModelCache::store(const std::string& key, const Node* tree) const
+{
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+
+    fs::path path = fs::path(directory) / (key + ".tree");
+    // pid and thread id: two threads or processes storing the same key never share a file
+    std::ostringstream suffix;
+    suffix << ".tmp." << getpid() << "." << std::hex << std::hash<std::thread::id>()(std::this_thread::get_id());
+    fs::path tmp = fs::path(directory) / (key + suffix.str());
+    {
+        std::ofstream file(tmp);
+        if (!file.is_open()) {
+            std::cerr << "Cache : impossible d'écrire " << tmp << std::endl;
+            return;
+        }
+        save_tree(tree, file);
+        if (!file) {
+            fs::remove(tmp, ec);
+            return;
+        }
+    }
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        fs::remove(tmp, ec);
+        return;
+    }
+    evict(key);
+}
+
+/**
+ * @brief Removes the least recently used trees until the cache fits in max_bytes.
+ *
+ * Temporary files older than an hour are left over by a crashed store and
+ * are removed too.
+ *
+ * @param keep Key that is never removed (the tree just stored).
+ */
+void ModelCache::evict(const std::string& keep) const
+{
+    struct Entry {
+        fs::path path;
+        fs::file_time_type time;
+        uintmax_t size;
+    };
+
+    std::error_code ec;
+    std::vector<Entry> entries;
+    uintmax_t total = 0;
+    auto stale = fs::file_time_type::clock::now() - std::chrono::hours(1);
+    for (const fs::directory_entry& e : fs::directory_iterator(directory, ec)) {
+        if (e.path().filename().string().find(".tmp.") != std::string::npos) {
+            if (e.last_write_time(ec) < stale)
+                fs::remove(e.path(), ec);
+            continue;
+        }
+        if (e.path().extension() != ".tree") continue;
+        uintmax_t size = e.file_size(ec);
+        entries.push_back({e.path(), e.last_write_time(ec), size});
+        total += size;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.time < b.time;
+    });
+    for (const Entry& e : entries) {
+        if (total <= max_bytes) break;
+        if (e.path.stem() == keep) continue;
+        if (fs::remove(e.path, ec))
+            total -= e.size;
+    }
+}
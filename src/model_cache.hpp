@@ -0,0 +1,36 @@
+#ifndef MODEL_CACHE_HPP
+#define MODEL_CACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include "decision_tree.hpp"
+
+uint64_t hash_file(const std::string& filename);
+std::string model_key(const std::string& dataset, const std::string& params);
+
+/**
+ * @brief Directory of trained trees, indexed by model_key().
+ *
+ * Trees are written to a temporary file (one per process and thread) then
+ * renamed, so a reader never sees a partial model. A hit refreshes the file
+ * date, and after each store the least recently used trees are removed until
+ * the directory fits in max_bytes.
+ */
+class ModelCache {
+public:
+    explicit ModelCache(const std::string& directory = default_directory(),
+                        uintmax_t max_bytes = 256u << 20);
+
+    Node* load(const std::string& key) const;
+    void store(const std::string& key, const Node* tree) const;
+
+    static std::string default_directory();
+
+private:
+    std::string directory;
+    uintmax_t max_bytes;
+
+    void evict(const std::string& keep) const;
+};
+
+#endif
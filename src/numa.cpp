@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "numa.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+static const size_t HUGE_PAGE_SIZE = 2u << 20;
+
+/**
+ * @brief Parses a kernel CPU list such as "0-3,8-11".
+ */
+static std::vector<int> parse_cpu_list(const std::string& text)
+{
+    std::vector<int> cpus;
+    std::stringstream ss(text);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        size_t dash = range.find('-');
+        int first = std::atoi(range.c_str());
+        int last = dash == std::string::npos ? first : std::atoi(range.c_str() + dash + 1);
+        for (int c = first; c <= last; ++c) cpus.push_back(c);
+    }
+    return cpus;
+}
+
+static NumaTopology detect_topology()
+{
+    NumaTopology topology;
+    const char* flag = std::getenv("PPN_NUMA");
+    bool enabled = !flag || std::strcmp(flag, "0") != 0;
+
+    DIR* dir = enabled ? opendir("/sys/devices/system/node") : nullptr;
+    if (dir) {
+        std::vector<int> ids;
+        while (dirent* entry = readdir(dir)) {
+            if (std::strncmp(entry->d_name, "node", 4) == 0 && std::isdigit(entry->d_name[4]))
+                ids.push_back(std::atoi(entry->d_name + 4));
+        }
+        closedir(dir);
+        std::sort(ids.begin(), ids.end());
+
+        for (int id : ids) {
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+            std::string text;
+            std::getline(file, text);
+            std::vector<int> cpus = parse_cpu_list(text);
+            if (cpus.empty()) continue;     // memory-only node
+            topology.node_ids.push_back(id);
+            topology.cpus.push_back(cpus);
+        }
+    }
+
+    // Single node holding every CPU: nothing will be bound
+    if (topology.nodes() <= 1) {
+        topology.node_ids.assign(1, 0);
+        topology.cpus.assign(1, std::vector<int>());
+        int n = std::max(1u, std::thread::hardware_concurrency());
+        for (int c = 0; c < n; ++c) topology.cpus[0].push_back(c);
+    }
+    return topology;
+}
+
+int NumaTopology::node_of_cpu(int cpu) const
+{
+    for (int node = 0; node < nodes(); ++node)
+        if (std::find(cpus[node].begin(), cpus[node].end(), cpu) != cpus[node].end())
+            return node;
+    return 0;
+}
+
+/**
+ * @brief Topology of the machine, read once.
+ */
+const NumaTopology& numa_topology()
+{
+    static const NumaTopology topology = detect_topology();
+    return topology;
+}
+
+/**
+ * @brief Node (index in numa_topology()) of the CPU running the calling thread.
+ */
+int current_numa_node()
+{
+    const NumaTopology& topology = numa_topology();
+    if (topology.nodes() == 1) return 0;
+#ifdef __linux__
+    int cpu = sched_getcpu();
+    if (cpu >= 0) return topology.node_of_cpu(cpu);
+#endif
+    return 0;
+}
+
+/**
+ * @brief Restricts the calling thread to the CPUs of a node.
+ *
+ * @return false if the machine has a single node or binding failed.
+ */
+bool bind_thread_to_node(int node)
+{
+    const NumaTopology& topology = numa_topology();
+    if (topology.nodes() == 1) return false;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : topology.cpus[node % topology.nodes()])
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+static bool huge_pages_enabled()
+{
+    static const bool enabled = [] {
+        const char* flag = std::getenv("PPN_HUGE_PAGES");
+        return !flag || std::strcmp(flag, "0") != 0;
+    }();
+    return enabled;
+}
+
+/**
+ * @brief Whether a buffer of this size is mapped on its own (else it comes from malloc).
+ */
+static bool mapped(size_t bytes)
+{
+#ifdef __linux__
+    return huge_pages_enabled() && bytes >= HUGE_PAGE_SIZE;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Allocates a buffer; from 2 MiB on it is 2 MiB aligned and advised for huge pages.
+ *
+ * The mapping is over-sized by one huge page and trimmed, so that every 2 MiB
+ * range of the buffer can be backed by a huge page. Throws std::bad_alloc.
+ */
+void* huge_alloc(size_t bytes)
+{
+    if (!mapped(bytes)) {
+        void* p = std::malloc(std::max<size_t>(bytes, 1));
+        if (!p) throw std::bad_alloc();
+        return p;
+    }
+#ifdef __linux__
+    size_t size = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    void* raw = mmap(nullptr, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) throw std::bad_alloc();
+
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = (start + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1);
+    if (aligned > start)
+        munmap(raw, aligned - start);
+    size_t tail = start + size + HUGE_PAGE_SIZE - (aligned + size);
+    if (tail > 0)
+        munmap(reinterpret_cast<void*>(aligned + size), tail);
+
+    void* p = reinterpret_cast<void*>(aligned);
+    madvise(p, size, MADV_HUGEPAGE);    // advisory: ignored if THP is disabled
+    return p;
+#else
+    return nullptr;
+#endif
+}
+
+void huge_free(void* p, size_t bytes)
+{
+    if (!p) return;
+    if (!mapped(bytes)) {
+        std::free(p);
+        return;
+    }
+#ifdef __linux__
+    size_t size = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    munmap(p, size);
+#endif
+}
+
+/**
+ * @brief Runs work(node, begin, end) on `parts` contiguous partitions of [0, n), in parallel.
+ *
+ * Partition k runs in a thread bound to node k % nodes (no binding on a
+ * single node), so buffers first written there are placed on that node.
+ * Code that later scans partition k should use the same split and node.
+ * A single partition runs on the calling thread, which is left unbound, so
+ * its buffers stay on the caller's node.
+ *
+ * @param parts Number of partitions and threads (0 = one per core), at most n.
+ */
+void numa_parallel_for(size_t n, int parts,
+                       const std::function<void(int node, size_t begin, size_t end)>& work)
+{
+    if (n == 0) return;
+    if (parts <= 0) parts = std::max(1u, std::thread::hardware_concurrency());
+    parts = std::min<size_t>(parts, n);
+    int nodes = numa_topology().nodes();
+
+    if (parts == 1) {
+        work(current_numa_node(), 0, n);
+        return;
+    }
+
+    auto run = [&](int k) {
+        int node = k % nodes;
+        if (nodes > 1) bind_thread_to_node(node);
+        work(node, n * k / parts, n * (k + 1) / parts);
+    };
+    std::vector<std::thread> threads;
+    for (int k = 0; k < parts; ++k)
+        threads.emplace_back(run, k);
+    for (std::thread& t : threads)
+        t.join();
+}
@@ -0,0 +1,109 @@
+#ifndef NUMA_HPP
+#define NUMA_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+/*
+ * Memory placement for the dataset and model buffers.
+ *
+ * - Large buffers are 2 MiB aligned and advised for transparent huge pages
+ *   (madvise MADV_HUGEPAGE), which cuts TLB misses in scans.
+ * - The NUMA nodes and their CPUs are read from /sys/devices/system/node.
+ *   Linux places a page on the node of the thread that first writes it;
+ *   numa_parallel_for() runs each partition in a thread bound to a node, so
+ *   a buffer is local only to threads that scan it with the same partition.
+ *   predict_batch_numa() does; the trainers scan from the calling thread.
+ * - NumaReplicas keeps one copy of a read-only model per node.
+ *
+ * Without /sys/devices/system/node (or with PPN_NUMA=0) the machine is seen
+ * as a single node and nothing is bound. PPN_HUGE_PAGES=0 disables huge pages.
+ */
+
+/**
+ * @brief NUMA nodes of the machine and the CPUs of each node.
+ */
+struct NumaTopology {
+    std::vector<int> node_ids;              // kernel ids of the nodes with CPUs
+    std::vector<std::vector<int>> cpus;     // CPUs of each node
+
+    int nodes() const { return cpus.size(); }
+    int node_of_cpu(int cpu) const;
+};
+
+const NumaTopology& numa_topology();
+int current_numa_node();
+bool bind_thread_to_node(int node);
+
+void* huge_alloc(size_t bytes);
+void huge_free(void* p, size_t bytes);
+
+/**
+ * @brief Standard allocator backed by huge_alloc(), for std::vector buffers.
+ *
+ * Pages are not touched by the allocation: they land on the node of the
+ * thread that fills the vector first.
+ */
+template <typename T>
+struct HugePageAllocator {
+    using value_type = T;
+
+    HugePageAllocator() = default;
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(huge_alloc(n * sizeof(T))); }
+    void deallocate(T* p, size_t n) { huge_free(p, n * sizeof(T)); }
+};
+
+template <typename T, typename U>
+bool operator==(const HugePageAllocator<T>&, const HugePageAllocator<U>&) { return true; }
+template <typename T, typename U>
+bool operator!=(const HugePageAllocator<T>&, const HugePageAllocator<U>&) { return false; }
+
+void numa_parallel_for(size_t n, int parts,
+                       const std::function<void(int node, size_t begin, size_t end)>& work);
+
+/**
+ * @brief One copy of a read-only object per NUMA node.
+ *
+ * Each replica is built by make() in a thread bound to its node, so all the
+ * memory it allocates and fills is local to that node. make() may run
+ * concurrently and must only read shared data. On a single-node machine (or
+ * with replicate = false) there is a single copy.
+ */
+template <typename T>
+class NumaReplicas {
+public:
+    template <typename Factory>
+    explicit NumaReplicas(Factory make, bool replicate = true) {
+        int nodes = replicate ? numa_topology().nodes() : 1;
+        replicas.resize(nodes);
+        if (nodes == 1) {
+            replicas[0].reset(new T(make()));
+            return;
+        }
+        std::vector<std::thread> threads;
+        for (int node = 0; node < nodes; ++node) {
+            threads.emplace_back([&, node] {
+                bind_thread_to_node(node);
+                replicas[node].reset(new T(make()));
+            });
+        }
+        for (std::thread& t : threads)
+            t.join();
+    }
+
+    int size() const { return replicas.size(); }
+    const T& on_node(int node) const { return *replicas[node % replicas.size()]; }
+    const T& local() const { return on_node(replicas.size() == 1 ? 0 : current_numa_node()); }
+
+private:
+    std::vector<std::unique_ptr<T>> replicas;
+};
+
+#endif
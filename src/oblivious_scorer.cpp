@@ -0,0 +1,255 @@
+#include "oblivious_scorer.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PPN_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Rows per block; a multiple of the widest vector (8 doubles)
+const int BLOCK = 64;
+
+/**
+ * @brief Adds the prediction of every tree to acc[0 .. BLOCK).
+ *
+ * xb holds the block transposed: feature f of row r is xb[f * BLOCK + r].
+ * A level sets its bit unless x <= threshold, so NaN goes right as in
+ * predict(Node*, ...).
+ * D > 0 is the depth known at compile time (levels unrolled), D = 0 reads it
+ * from the scorer. Trees are summed in order, as in predict().
+ */
+using BlockKernel = void (*)(const ObliviousScorer&, const double*, double*);
+
+template <int D>
+void block_scalar(const ObliviousScorer& s, const double* xb, double* acc)
+{
+    const int depth = D > 0 ? D : s.depth;
+    for (int r = 0; r < BLOCK; ++r) {
+        double sum = acc[r];
+        for (int t = 0; t < s.n_trees; ++t) {
+            const int* f = &s.features[t * depth];
+            const double* th = &s.thresholds[t * depth];
+            unsigned leaf = 0;
+            for (int d = 0; d < depth; ++d)
+                leaf |= unsigned(!(xb[f[d] * BLOCK + r] <= th[d])) << d;
+            sum += s.leaf_values[(static_cast<size_t>(t) << depth) + leaf];
+        }
+        acc[r] = sum;
+    }
+}
+
+#ifdef PPN_X86_KERNELS
+
+template <int D>
+__attribute__((target("avx2")))
+void block_avx2(const ObliviousScorer& s, const double* xb, double* acc)
+{
+    const int depth = D > 0 ? D : s.depth;
+    for (int r = 0; r < BLOCK; r += 4) {
+        __m256d sum = _mm256_loadu_pd(acc + r);
+        for (int t = 0; t < s.n_trees; ++t) {
+            const int* f = &s.features[t * depth];
+            const double* th = &s.thresholds[t * depth];
+            __m256i leaf = _mm256_setzero_si256();
+            for (int d = 0; d < depth; ++d) {
+                __m256d right = _mm256_cmp_pd(_mm256_loadu_pd(xb + f[d] * BLOCK + r),
+                                              _mm256_set1_pd(th[d]), _CMP_NLE_UQ);
+                leaf = _mm256_or_si256(leaf, _mm256_and_si256(_mm256_castpd_si256(right),
+                                                              _mm256_set1_epi64x(1LL << d)));
+            }
+            const double* leaves = &s.leaf_values[static_cast<size_t>(t) << depth];
+            sum = _mm256_add_pd(sum, _mm256_i64gather_pd(leaves, leaf, 8));
+        }
+        _mm256_storeu_pd(acc + r, sum);
+    }
+}
+
+template <int D>
+__attribute__((target("avx512f")))
+void block_avx512(const ObliviousScorer& s, const double* xb, double* acc)
+{
+    const int depth = D > 0 ? D : s.depth;
+    for (int r = 0; r < BLOCK; r += 8) {
+        __m512d sum = _mm512_loadu_pd(acc + r);
+        for (int t = 0; t < s.n_trees; ++t) {
+            const int* f = &s.features[t * depth];
+            const double* th = &s.thresholds[t * depth];
+            __m512i leaf = _mm512_setzero_si512();
+            for (int d = 0; d < depth; ++d) {
+                __mmask8 right = _mm512_cmp_pd_mask(_mm512_loadu_pd(xb + f[d] * BLOCK + r),
+                                                    _mm512_set1_pd(th[d]), _CMP_NLE_UQ);
+                leaf = _mm512_mask_or_epi64(leaf, right, leaf, _mm512_set1_epi64(1LL << d));
+            }
+            const double* leaves = &s.leaf_values[static_cast<size_t>(t) << depth];
+            sum = _mm512_add_pd(sum, _mm512_i64gather_pd(leaf, leaves, 8));
+        }
+        _mm512_storeu_pd(acc + r, sum);
+    }
+}
+
+#endif
+
+enum class Isa { Scalar, AVX2, AVX512 };
+
+struct IsaChoice {
+    Isa isa;
+    const char* name;
+};
+
+/**
+ * @brief Picks the widest instruction set supported by the CPU.
+ *
+ * The environment variable PPN_OBLIVIOUS_KERNEL ("scalar", "avx2") can force
+ * a narrower kernel, which is useful to compare the versions.
+ */
+IsaChoice select_isa()
+{
+    const char* forced = std::getenv("PPN_OBLIVIOUS_KERNEL");
+    bool allow_avx512 = !forced || std::strcmp(forced, "avx512") == 0;
+    bool allow_avx2 = allow_avx512 || std::strcmp(forced, "avx2") == 0;
+
+#ifdef PPN_X86_KERNELS
+    __builtin_cpu_init();
+    if (allow_avx512 && __builtin_cpu_supports("avx512f"))
+        return {Isa::AVX512, "avx512"};
+    if (allow_avx2 && __builtin_cpu_supports("avx2"))
+        return {Isa::AVX2, "avx2"};
+#else
+    (void)allow_avx2;
+#endif
+    return {Isa::Scalar, "scalar"};
+}
+
+const IsaChoice& isa_choice()
+{
+    static const IsaChoice choice = select_isa();
+    return choice;
+}
+
+template <int D>
+BlockKernel kernel_for(Isa isa)
+{
+#ifdef PPN_X86_KERNELS
+    if (isa == Isa::AVX512) return block_avx512<D>;
+    if (isa == Isa::AVX2) return block_avx2<D>;
+#else
+    (void)isa;
+#endif
+    return block_scalar<D>;
+}
+
+/**
+ * @brief Kernel for a depth: unrolled for 4..10, generic otherwise.
+ */
+BlockKernel select_kernel(int depth)
+{
+    Isa isa = isa_choice().isa;
+    switch (depth) {
+    case 4: return kernel_for<4>(isa);
+    case 5: return kernel_for<5>(isa);
+    case 6: return kernel_for<6>(isa);
+    case 7: return kernel_for<7>(isa);
+    case 8: return kernel_for<8>(isa);
+    case 9: return kernel_for<9>(isa);
+    case 10: return kernel_for<10>(isa);
+    default: return kernel_for<0>(isa);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Packs the trees, padded to the depth of the deepest one.
+ *
+ * A padding level compares feature 0 with +infinity (left, except for NaN)
+ * and the leaves it adds repeat the leaf values, so its bit has no effect.
+ *
+ * @param average Predict the mean of the trees (true) or their sum.
+ */
+ObliviousScorer::ObliviousScorer(const std::vector<ObliviousTree>& trees, bool average)
+    : average(average)
+{
+    n_trees = trees.size();
+    for (const ObliviousTree& tree : trees) {
+        depth = std::max(depth, tree.depth());
+        for (int f : tree.features)
+            n_features = std::max(n_features, f + 1);
+    }
+    n_features = std::max(n_features, 1);
+    if (depth > 20)
+        throw std::invalid_argument("ObliviousScorer: trees deeper than 20 levels are not supported");
+
+    const double inf = std::numeric_limits<double>::infinity();
+    size_t leaves = size_t(1) << depth;
+    for (const ObliviousTree& tree : trees) {
+        for (int d = 0; d < depth; ++d) {
+            features.push_back(d < tree.depth() ? tree.features[d] : 0);
+            thresholds.push_back(d < tree.depth() ? tree.thresholds[d] : inf);
+        }
+        size_t mask = (size_t(1) << tree.depth()) - 1;
+        for (size_t l = 0; l < leaves; ++l)
+            leaf_values.push_back(tree.leaf_values[l & mask]);
+    }
+}
+
+/**
+ * @brief Mean (or sum) of the tree predictions for one sample (scalar path).
+ */
+double ObliviousScorer::predict(const std::vector<double>& sample) const
+{
+    if (n_trees == 0) return 0.0;
+    double sum = 0.0;
+    for (int t = 0; t < n_trees; ++t) {
+        unsigned leaf = 0;
+        for (int d = 0; d < depth; ++d)
+            leaf |= unsigned(!(sample[features[t * depth + d]] <= thresholds[t * depth + d])) << d;
+        sum += leaf_values[(static_cast<size_t>(t) << depth) + leaf];
+    }
+    return average ? sum / n_trees : sum;
+}
+
+/**
+ * @brief Mean (or sum) of the tree predictions for every row of X, by blocks of rows.
+ *
+ * Gives the same values as predict() (the trees are summed in the same order).
+ */
+void ObliviousScorer::predict_batch(const std::vector<std::vector<double>>& X,
+                                    std::vector<double>& out) const
+{
+    int n = X.size();
+    out.assign(n, 0.0);
+    if (n_trees == 0) return;
+
+    BlockKernel kernel = select_kernel(depth);
+    std::vector<double> xb(static_cast<size_t>(n_features) * BLOCK, 0.0);
+    std::vector<double> acc(BLOCK);
+
+    for (int start = 0; start < n; start += BLOCK) {
+        int rows = std::min(BLOCK, n - start);
+        for (int r = 0; r < rows; ++r) {
+            const std::vector<double>& row = X[start + r];
+            for (int f = 0; f < n_features; ++f)
+                xb[f * BLOCK + r] = row[f];
+        }
+
+        std::fill(acc.begin(), acc.end(), 0.0);
+        kernel(*this, xb.data(), acc.data());
+        for (int r = 0; r < rows; ++r)
+            out[start + r] = average ? acc[r] / n_trees : acc[r];
+    }
+}
+
+/**
+ * @brief Name of the kernel selected for this CPU ("avx512", "avx2" or "scalar").
+ */
+const char* ObliviousScorer::kernel_name() const
+{
+    return isa_choice().name;
+}
@@ -0,0 +1,44 @@
+#ifndef OBLIVIOUS_SCORER_HPP
+#define OBLIVIOUS_SCORER_HPP
+
+#include <vector>
+#include "oblivious_tree.hpp"
+
+/**
+ * @brief Batched, branch-free inference of an ensemble of oblivious trees.
+ *
+ * The trees are padded to the same depth D (extra levels whose leaves are
+ * duplicated) and packed in flat arrays. Rows are
+ * scored by blocks: a block is transposed to columns, then for each tree
+ * 8 (AVX-512) or 4 (AVX2) rows compare their feature against the level
+ * threshold at once, the comparison masks are OR-ed into the leaf indices
+ * and the leaf values are gathered. Kernels are specialized at compile time
+ * for D = 4..10 (fully unrolled levels), with a generic one for other
+ * depths; the widest kernel supported by the CPU is chosen at run time
+ * (PPN_OBLIVIOUS_KERNEL = "scalar" or "avx2" forces a narrower one).
+ *
+ * The prediction is the mean of the trees (bagging), or their sum with
+ * average = false (trees fitted to residuals, i.e. boosting).
+ */
+class ObliviousScorer {
+public:
+    explicit ObliviousScorer(const std::vector<ObliviousTree>& trees, bool average = true);
+
+    double predict(const std::vector<double>& sample) const;
+    void predict_batch(const std::vector<std::vector<double>>& X,
+                       std::vector<double>& out) const;
+    const char* kernel_name() const;
+
+    int n_trees = 0;
+    int depth = 0;
+    int n_features = 0;
+    bool average = true;    // mean of the trees, else their sum
+
+    // Level d of tree t: features[t * depth + d], thresholds[t * depth + d]
+    std::vector<int> features;
+    std::vector<double> thresholds;
+    // Leaf l of tree t: leaf_values[(t << depth) + l]
+    std::vector<double> leaf_values;
+};
+
+#endif
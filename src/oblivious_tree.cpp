@@ -0,0 +1,171 @@
+#include <algorithm>
+#include "oblivious_tree.hpp"
+
+/**
+ * @brief SSE of the two children of a leaf, from their centered sums.
+ *
+ * The right child gets what the left one does not have.
+ */
+static double children_sse(double count, double total, double total_sq,
+                           double lc, double ls, double lsq)
+{
+    double sse = 0.0;
+    if (lc > 0.0) sse += lsq - ls * ls / lc;
+    double rc = count - lc;
+    if (rc > 0.0) {
+        double rs = total - ls;
+        sse += (total_sq - lsq) - rs * rs / rc;
+    }
+    return sse;
+}
+
+/**
+ * @brief Trains an oblivious tree one level at a time.
+ *
+ * At each level, every (feature, threshold) is scored by the summed SSE of
+ * the children of all current leaves (i.e. the summed gain), and the best
+ * one splits every leaf. As in build_tree_level_wise(), each feature is read
+ * once per level in the sorted order of the Dataset; the leaf sums are
+ * updated row by row and the total SSE is kept up to date incrementally, so
+ * a level costs O(n · m). Ties go to the lowest feature.
+ *
+ * Growth stops early if no split lowers the SSE by more than 1e-9 of the
+ * summed squares of the leaves: the incremental SSE drifts by rounding, and
+ * on a (nearly) constant target that drift alone must not pick a split. An
+ * empty leaf gets the value of its parent.
+ *
+ * @param data Column-major dataset with sorted row orders (make_dataset())
+ * @param depth Number of levels
+ * @param targets Values to fit instead of data.y (e.g. residuals, to be
+ *        summed with ObliviousScorer(trees, false)), optional
+ */
+ObliviousTree build_oblivious_tree(const Dataset& data, int depth, const std::vector<double>* targets)
+{
+    const std::vector<double>& y = targets ? *targets : data.y;
+    int n = data.rows();
+    int m = data.features();
+
+    ObliviousTree tree;
+    std::vector<int> leaf_of(n, 0);
+
+    // Mean and centered sums of each leaf of the current level
+    std::vector<double> count(1, n), mean(1, 0.0), total, total_sq;
+    for (int r = 0; r < n; ++r) mean[0] += y[r];
+    if (n > 0) mean[0] /= n;
+
+    for (int d = 0; d < depth && n > 0; ++d) {
+        int leaves = 1 << d;
+        total.assign(leaves, 0.0);
+        total_sq.assign(leaves, 0.0);
+        for (int r = 0; r < n; ++r) {
+            double v = y[r] - mean[leaf_of[r]];
+            total[leaf_of[r]] += v;
+            total_sq[leaf_of[r]] += v * v;
+        }
+        double parent_sse = 0.0, scale = 0.0;
+        for (int l = 0; l < leaves; ++l) {
+            parent_sse += count[l] > 0.0 ? total_sq[l] - total[l] * total[l] / count[l] : 0.0;
+            scale += total_sq[l];
+        }
+
+        // A split must gain more than the rounding drift of the incremental SSE
+        int best_feature = -1;
+        double best_threshold = 0.0, best_sse = parent_sse - 1e-9 * scale;
+        std::vector<double> lc(leaves), ls(leaves), lsq(leaves);
+        for (int f = 0; f < m; ++f) {
+            std::fill(lc.begin(), lc.end(), 0.0);
+            std::fill(ls.begin(), ls.end(), 0.0);
+            std::fill(lsq.begin(), lsq.end(), 0.0);
+            double sse = parent_sse;
+
+            const RowOrder& order = data.sorted_rows[f];
+            const Column& x = data.columns[f];
+            for (int i = 0; i + 1 < n; ++i) {
+                int r = order[i];
+                int l = leaf_of[r];
+                double v = y[r] - mean[l];
+                sse -= children_sse(count[l], total[l], total_sq[l], lc[l], ls[l], lsq[l]);
+                lc[l] += 1.0;
+                ls[l] += v;
+                lsq[l] += v * v;
+                sse += children_sse(count[l], total[l], total_sq[l], lc[l], ls[l], lsq[l]);
+
+                double a = x[r], b = x[order[i + 1]];
+                if (a < b && sse < best_sse) {
+                    best_sse = sse;
+                    best_feature = f;
+                    best_threshold = (a + b) / 2.0;
+                }
+            }
+        }
+        if (best_feature == -1)
+            break;
+
+        // Split every leaf: the new bit d is set on the right
+        const Column& x = data.columns[best_feature];
+        std::vector<double> child_count(2 * leaves, 0.0), child_mean(2 * leaves, 0.0);
+        for (int r = 0; r < n; ++r) {
+            leaf_of[r] |= !(x[r] <= best_threshold) << d;
+            child_count[leaf_of[r]] += 1.0;
+            child_mean[leaf_of[r]] += y[r];
+        }
+        for (int l = 0; l < 2 * leaves; ++l) {
+            int parent = l & (leaves - 1);
+            child_mean[l] = child_count[l] > 0.0 ? child_mean[l] / child_count[l] : mean[parent];
+        }
+        count.swap(child_count);
+        mean.swap(child_mean);
+        tree.features.push_back(best_feature);
+        tree.thresholds.push_back(best_threshold);
+    }
+
+    tree.leaf_values = mean;
+    tree.leaf_samples = count;
+    return tree;
+}
+
+/**
+ * @brief Predicts one sample: the leaf index is built from the level comparisons.
+ */
+double predict(const ObliviousTree& tree, const std::vector<double>& sample)
+{
+    unsigned leaf = 0;
+    for (int d = 0; d < tree.depth(); ++d)
+        leaf |= unsigned(!(sample[tree.features[d]] <= tree.thresholds[d])) << d;
+    return tree.leaf_values[leaf];
+}
+
+/**
+ * @brief Builds the node of the leaves whose low `level` bits are `prefix`.
+ */
+static Node* oblivious_node(const ObliviousTree& tree, int level, unsigned prefix)
+{
+    Node* node = new Node();
+    if (level == tree.depth()) {
+        node->is_leaf = true;
+        node->value = tree.leaf_values[prefix];
+        node->samples = tree.leaf_samples[prefix];
+        node->sum = node->value * node->samples;
+        return node;
+    }
+    node->feature_index = tree.features[level];
+    node->threshold = tree.thresholds[level];
+    node->left = oblivious_node(tree, level + 1, prefix);
+    node->right = oblivious_node(tree, level + 1, prefix | (1u << level));
+    node->samples = node->left->samples + node->right->samples;
+    node->sum = node->left->sum + node->right->sum;
+    node->value = node->samples > 0.0 ? node->sum / node->samples : node->left->value;
+    return node;
+}
+
+/**
+ * @brief Copy of an oblivious tree as a regular Node tree (2^depth leaves).
+ *
+ * Gives access to the tools working on Node trees (save_tree(), QuickScorer,
+ * partial_dependence(), ...). Nodes hold their sample count and Σy; Σy² is
+ * not known and stays 0.
+ */
+Node* oblivious_to_tree(const ObliviousTree& tree)
+{
+    return oblivious_node(tree, 0, 0);
+}
@@ -0,0 +1,35 @@
+#ifndef OBLIVIOUS_TREE_HPP
+#define OBLIVIOUS_TREE_HPP
+
+#include <vector>
+#include "dataset.hpp"
+#include "decision_tree.hpp"
+
+/**
+ * @brief Oblivious (symmetric) regression tree.
+ *
+ * All the nodes of level d share the split (features[d], thresholds[d]).
+ * The leaf of a sample is the bit vector of the level comparisons: bit d is
+ * set unless x[features[d]] <= thresholds[d], so NaN goes right as in
+ * predict(Node*, ...). A prediction is depth compares and one table
+ * lookup, with no data-dependent branch.
+ *
+ * leaf_values: 2^depth values, indexed by the bit vector.
+ * leaf_samples: training rows of each leaf.
+ */
+struct ObliviousTree {
+    std::vector<int> features;
+    std::vector<double> thresholds;
+    std::vector<double> leaf_values;
+    std::vector<double> leaf_samples;
+
+    int depth() const { return features.size(); }
+};
+
+ObliviousTree build_oblivious_tree(const Dataset& data,
+                                   int depth = 6,
+                                   const std::vector<double>* targets = nullptr);
+double predict(const ObliviousTree& tree, const std::vector<double>& sample);
+Node* oblivious_to_tree(const ObliviousTree& tree);
+
+#endif
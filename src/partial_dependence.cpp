@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include "partial_dependence.hpp"
+
+/**
+ * @brief Grid of values of a feature: its distinct values if there are at most
+ * `resolution` of them, else `resolution` evenly spaced values between the
+ * lower and upper percentiles (which keeps outliers out of the grid).
+ */
+std::vector<double> feature_grid(const std::vector<std::vector<double>>& X,
+                                 int feature,
+                                 int resolution,
+                                 double lower,
+                                 double upper)
+{
+    std::vector<double> values;
+    values.reserve(X.size());
+    for (const std::vector<double>& row : X)
+        values.push_back(row[feature]);
+    std::sort(values.begin(), values.end());
+
+    std::vector<double> distinct = values;
+    distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+    if (static_cast<int>(distinct.size()) <= resolution)
+        return distinct;
+
+    auto percentile = [&](double q) {
+        double pos = q * (values.size() - 1);
+        size_t i = static_cast<size_t>(pos);
+        double t = pos - i;
+        return i + 1 < values.size() ? values[i] * (1.0 - t) + values[i + 1] * t : values[i];
+    };
+    double lo = percentile(lower), hi = percentile(upper);
+
+    std::vector<double> grid(resolution);
+    for (int k = 0; k < resolution; ++k)
+        grid[k] = resolution > 1 ? lo + (hi - lo) * k / (resolution - 1) : lo;
+    return grid;
+}
+
+/**
+ * @brief Partial dependence of one tree at one grid point (weighted tree traversal).
+ *
+ * At a node split on a studied feature, only the branch taken by the grid
+ * point is followed. At any other node both branches are followed, weighted
+ * by the fraction of training samples that went to each child (Node::samples).
+ * No row is visited. The result equals the average prediction over the
+ * training rows with the studied features set to the grid point when those
+ * features are independent of the others (e.g. a full factorial design);
+ * otherwise each split averages over the rows that reached its node.
+ */
+static double tree_dependence(const Node* node, const int* features, const double* point, int k)
+{
+    while (!node->is_leaf) {
+        int j = 0;
+        while (j < k && features[j] != node->feature_index) ++j;
+        if (j < k) {
+            node = point[j] <= node->threshold ? node->left : node->right;
+            continue;
+        }
+
+        double wl = node->left->samples, wr = node->right->samples;
+        if (wl + wr <= 0.0) wl = wr = 1.0;     // trees saved without statistics
+        return (wl * tree_dependence(node->left, features, point, k) +
+                wr * tree_dependence(node->right, features, point, k)) / (wl + wr);
+    }
+    return node->value;
+}
+
+/**
+ * @brief Partial dependence of an ensemble (mean of its trees) on the given grid.
+ *
+ * Costs O(grid points × nodes) and does not depend on the size of the
+ * dataset. Each (tree, grid point) pair is an independent job, shared by
+ * n_threads threads; the tree contributions are summed in a fixed order, so
+ * the result does not depend on the number of threads.
+ *
+ * @param trees Trees of the model (a single tree: {root}).
+ * @param features One or two studied features.
+ * @param grid Values of each studied feature (see feature_grid()).
+ * @param n_threads Number of threads (0 = one per core).
+ */
+PartialDependence partial_dependence(const std::vector<Node*>& trees,
+                                     const std::vector<int>& features,
+                                     const std::vector<std::vector<double>>& grid,
+                                     int n_threads)
+{
+    if (features.empty() || features.size() > 2 || grid.size() != features.size())
+        throw std::invalid_argument("partial_dependence: one or two features, with one grid each");
+
+    PartialDependence result;
+    result.features = features;
+    result.grid = grid;
+
+    int k = features.size();
+    int inner = k == 2 ? grid[1].size() : 1;
+    int points = grid[0].size() * inner;
+    int n_trees = trees.size();
+    result.values.assign(points, 0.0);
+    if (points == 0 || n_trees == 0) return result;
+
+    int jobs = n_trees * points;
+    std::vector<double> contribution(jobs);
+    std::atomic<int> next_job(0);
+
+    auto worker = [&]() {
+        double point[2];
+        for (int job = next_job++; job < jobs; job = next_job++) {
+            int t = job / points, p = job % points;
+            point[0] = grid[0][p / inner];
+            if (k == 2) point[1] = grid[1][p % inner];
+            contribution[job] = tree_dependence(trees[t], features.data(), point, k);
+        }
+    };
+
+    if (n_threads <= 0)
+        n_threads = std::max(1u, std::thread::hardware_concurrency());
+    n_threads = std::min(n_threads, jobs);
+    std::vector<std::thread> threads;
+    for (int t = 1; t < n_threads; ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread& t : threads)
+        t.join();
+
+    for (int t = 0; t < n_trees; ++t)
+        for (int p = 0; p < points; ++p)
+            result.values[p] += contribution[t * points + p] / n_trees;
+    return result;
+}
+
+/**
+ * @brief Partial dependence on a grid built from the training data (feature_grid()).
+ */
+PartialDependence partial_dependence(const std::vector<Node*>& trees,
+                                     const std::vector<std::vector<double>>& X,
+                                     const std::vector<int>& features,
+                                     int resolution,
+                                     int n_threads)
+{
+    std::vector<std::vector<double>> grid;
+    for (int f : features)
+        grid.push_back(feature_grid(X, f, resolution));
+    return partial_dependence(trees, features, grid, n_threads);
+}
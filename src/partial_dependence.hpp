@@ -0,0 +1,36 @@
+#ifndef PARTIAL_DEPENDENCE_HPP
+#define PARTIAL_DEPENDENCE_HPP
+
+#include <vector>
+#include "decision_tree.hpp"
+
+/**
+ * @brief Partial dependence of a model on one or two features.
+ *
+ * features: the studied features (1 or 2).
+ * grid: values taken by each studied feature.
+ * values: average prediction at each grid point; for two features the point
+ *         (grid[0][i], grid[1][j]) is at values[i * grid[1].size() + j].
+ */
+struct PartialDependence {
+    std::vector<int> features;
+    std::vector<std::vector<double>> grid;
+    std::vector<double> values;
+};
+
+std::vector<double> feature_grid(const std::vector<std::vector<double>>& X,
+                                 int feature,
+                                 int resolution = 20,
+                                 double lower = 0.05,
+                                 double upper = 0.95);
+PartialDependence partial_dependence(const std::vector<Node*>& trees,
+                                     const std::vector<int>& features,
+                                     const std::vector<std::vector<double>>& grid,
+                                     int n_threads = 0);
+PartialDependence partial_dependence(const std::vector<Node*>& trees,
+                                     const std::vector<std::vector<double>>& X,
+                                     const std::vector<int>& features,
+                                     int resolution = 20,
+                                     int n_threads = 0);
+
+#endif
@@ -0,0 +1,229 @@
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <string>
+#include "ppntree.h"
+#include "DecisionTreeRegressor.hpp"
+
+/**
+ * @brief Model handle of the C interface.
+ */
+struct ppntree {
+    DecisionTreeRegressor tree;
+    long n_features = 0;
+};
+
+static thread_local std::string last_error;
+static thread_local const char* last_message = "";
+
+/**
+ * @brief Records the error of the calling thread: prefix followed by detail.
+ *
+ * Never throws, so it is safe in the catch blocks of the C functions: if the
+ * message cannot be allocated, a static one is reported instead.
+ */
+static int fail(const char* prefix, const char* detail = "") noexcept
+{
+    try {
+        last_error = prefix;
+        last_error += detail;
+        last_message = last_error.c_str();
+    } catch (...) {
+        last_message = "ppntree: out of memory while reporting an error";
+    }
+    return -1;
+}
+
+/**
+ * @brief Checks that every split of a loaded tree reads one of the n_features columns.
+ */
+static bool valid_features(const Node* node, long n_features)
+{
+    if (node->is_leaf)
+        return true;
+    if (node->feature_index < 0 || node->feature_index >= n_features)
+        return false;
+    return valid_features(node->left, n_features) && valid_features(node->right, n_features);
+}
+
+/**
+ * @brief Walks the tree for one row read in place with a column stride.
+ */
+static double predict_row(const Node* node, const double* row, long col_stride)
+{
+    while (!node->is_leaf)
+        node = row[node->feature_index * col_stride] <= node->threshold ? node->left : node->right;
+    return node->value;
+}
+
+extern "C" {
+
+void ppntree_default_params(ppntree_params* params)
+{
+    DecisionTreeRegressor defaults;
+    params->max_depth = defaults.max_depth;
+    params->min_samples_split = defaults.min_samples_split;
+    params->min_gain = defaults.min_gain;
+    params->splitter = defaults.splitter == SplitStrategy::Random ? 1 : 0;
+    params->max_features = defaults.max_features;
+    params->seed = defaults.seed;
+    params->criterion = static_cast<int>(defaults.criterion);
+}
+
+ppntree* ppntree_fit(const double* X, long n_rows, long n_features,
+                     long row_stride, long col_stride,
+                     const double* y, long y_stride,
+                     const ppntree_params* params)
+{
+    if (!X || !y || n_rows <= 0 || n_features <= 0) {
+        fail("ppntree_fit: empty or null input");
+        return nullptr;
+    }
+
+    // The builders work on rows of std::vector. The regressor keeps no copy
+    // (keep_training_data stays false), so these are freed once the tree is built.
+    std::vector<std::vector<double>> rows;
+    std::vector<double> target;
+    ppntree* model = nullptr;
+    try {
+        rows.assign(n_rows, std::vector<double>(n_features));
+        target.resize(n_rows);
+        for (long i = 0; i < n_rows; ++i) {
+            for (long f = 0; f < n_features; ++f)
+                rows[i][f] = X[i * row_stride + f * col_stride];
+            target[i] = y[i * y_stride];
+        }
+
+        model = new ppntree();
+        model->n_features = n_features;
+        if (params) {
+            model->tree.max_depth = params->max_depth;
+            model->tree.min_samples_split = params->min_samples_split;
+            model->tree.min_gain = params->min_gain;
+            model->tree.splitter = params->splitter == 1 ? SplitStrategy::Random : SplitStrategy::Best;
+            model->tree.max_features = params->max_features;
+            model->tree.seed = params->seed;
+            if (params->criterion < 0 || params->criterion > static_cast<int>(SplitCriterion::Poisson)) {
+                delete model;
+                fail("ppntree_fit: unknown criterion");
+                return nullptr;
+            }
+            model->tree.criterion = static_cast<SplitCriterion>(params->criterion);
+        }
+        model->tree.fit(rows, target);
+    } catch (const std::exception& e) {
+        delete model;
+        fail("ppntree_fit: ", e.what());
+        return nullptr;
+    } catch (...) {
+        delete model;
+        fail("ppntree_fit: unknown error");
+        return nullptr;
+    }
+    return model;
+}
+
+int ppntree_predict_batch(const ppntree* model,
+                          const double* X, long n_rows, long n_features,
+                          long row_stride, long col_stride,
+                          double* out)
+{
+    if (!model || !model->tree.root || !X || !out)
+        return fail("ppntree_predict_batch: null model or buffer");
+    try {
+        if (n_features != model->n_features)
+            return fail(("ppntree_predict_batch: expected " + std::to_string(model->n_features) +
+                         " features, got " + std::to_string(n_features)).c_str());
+        for (long i = 0; i < n_rows; ++i)
+            out[i] = predict_row(model->tree.root, X + i * row_stride, col_stride);
+    } catch (const std::exception& e) {
+        return fail("ppntree_predict_batch: ", e.what());
+    } catch (...) {
+        return fail("ppntree_predict_batch: unknown error");
+    }
+    return 0;
+}
+
+int ppntree_save(const ppntree* model, const char* path)
+{
+    if (!model || !model->tree.root || !path)
+        return fail("ppntree_save: null model or path");
+
+    try {
+        std::ofstream file(path);
+        if (!file.is_open())
+            return fail("ppntree_save: cannot open ", path);
+        file << "ppntree 1 " << model->n_features << "\n";
+        save_tree(model->tree.root, file);
+        return file ? 0 : fail("ppntree_save: cannot write ", path);
+    } catch (const std::exception& e) {
+        return fail("ppntree_save: ", e.what());
+    } catch (...) {
+        return fail("ppntree_save: unknown error");
+    }
+}
+
+ppntree* ppntree_load(const char* path)
+{
+    if (!path) {
+        fail("ppntree_load: null path");
+        return nullptr;
+    }
+    try {
+        std::ifstream file(path);
+        std::string magic;
+        int version = 0;
+        long n_features = 0;
+        if (!file.is_open() || !(file >> magic >> version >> n_features) || magic != "ppntree" || version != 1) {
+            fail("ppntree_load: not a ppntree model: ", path);
+            return nullptr;
+        }
+        if (n_features <= 0) {
+            fail("ppntree_load: invalid feature count in ", path);
+            return nullptr;
+        }
+
+        // The model owns the tree as soon as it is read, so every failure below frees it
+        std::unique_ptr<ppntree> model(new ppntree());
+        model->n_features = n_features;
+        model->tree.root = load_tree(file);
+        if (!model->tree.root) {
+            fail("ppntree_load: truncated model: ", path);
+            return nullptr;
+        }
+        // predict_row() indexes the rows with feature_index: never trust the file
+        if (!valid_features(model->tree.root, n_features)) {
+            fail("ppntree_load: split on a feature out of range in ", path);
+            return nullptr;
+        }
+        return model.release();
+    } catch (const std::exception& e) {
+        fail("ppntree_load: ", e.what());
+        return nullptr;
+    } catch (...) {
+        fail("ppntree_load: unknown error");
+        return nullptr;
+    }
+}
+
+long ppntree_n_features(const ppntree* model)
+{
+    return model ? model->n_features : 0;
+}
+
+long ppntree_n_leaves(const ppntree* model)
+{
+    return model && model->tree.root ? count_leaves(model->tree.root) : 0;
+}
+
+void ppntree_free(ppntree* model)
+{
+    delete model;
+}
+
+const char* ppntree_last_error(void)
+{
+    return last_message;
+}
+
+}
@@ -0,0 +1,56 @@
+#ifndef PPNTREE_H
+#define PPNTREE_H
+
+/*
+ * C interface of the decision tree library (libppntree).
+ *
+ * Matrices are passed as a pointer, a shape and strides counted in elements
+ * (not bytes), so row-major, column-major and sliced NumPy arrays can all be
+ * read in place. Functions returning int give 0 on success and -1 on error;
+ * ppntree_last_error() then describes the error.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ppntree ppntree;
+
+/* Training parameters, see DecisionTreeRegressor. splitter: 0 = best, 1 = random.
+ * criterion: 0 = mse, 1 = friedman_mse, 2 = mae, 3 = poisson. */
+typedef struct {
+    int max_depth;
+    int min_samples_split;
+    double min_gain;
+    int splitter;
+    int max_features;
+    unsigned seed;
+    int criterion;
+} ppntree_params;
+
+void ppntree_default_params(ppntree_params* params);
+
+ppntree* ppntree_fit(const double* X, long n_rows, long n_features,
+                     long row_stride, long col_stride,
+                     const double* y, long y_stride,
+                     const ppntree_params* params);
+
+int ppntree_predict_batch(const ppntree* model,
+                          const double* X, long n_rows, long n_features,
+                          long row_stride, long col_stride,
+                          double* out);
+
+int ppntree_save(const ppntree* model, const char* path);
+ppntree* ppntree_load(const char* path);
+
+long ppntree_n_features(const ppntree* model);
+long ppntree_n_leaves(const ppntree* model);
+void ppntree_free(ppntree* model);
+
+const char* ppntree_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
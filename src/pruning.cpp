@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include "pruning.hpp"
+
+/**
+ * @brief Stores the nodes of a subtree in preorder, with their parent.
+ */
+static void collect_preorder(Node* node, int parent, PruningPath& path, std::vector<int>& parents)
+{
+    int index = path.nodes.size();
+    path.nodes.push_back(node);
+    path.subtree_end.push_back(0);
+    parents.push_back(parent);
+    if (!node->is_leaf) {
+        collect_preorder(node->left, index, path, parents);
+        collect_preorder(node->right, index, path, parents);
+    }
+    path.subtree_end[index] = path.nodes.size();
+}
+
+/**
+ * @brief Computes the minimal cost-complexity pruning path (weakest link).
+ *
+ * One bottom-up pass gives, for each internal node t, the SSE of its subtree
+ * R(T_t), its number of leaves |T_t| and its link strength
+ * g(t) = (R(t) - R(T_t)) / (|T_t| - 1). The weakest link is then collapsed
+ * repeatedly (min-heap on g with lazy updates, only the ancestors change),
+ * which gives the alpha from which every node becomes a leaf.
+ * The tree is not modified; the node statistics must be filled
+ * (set_node_stats()).
+ *
+ * @param root Root of the tree.
+ * @return Pruning path, with the prune alpha of every node.
+ */
+PruningPath cost_complexity_path(Node* root)
+{
+    PruningPath path;
+    std::vector<int> parents;
+    collect_preorder(root, -1, path, parents);
+
+    int n = path.nodes.size();
+    std::vector<double> subtree_sse(n, 0.0);
+    std::vector<int> subtree_leaves(n, 0);
+    std::vector<bool> collapsed(n, false);
+    path.prune_alpha.assign(n, 0.0);
+
+    // Bottom-up pass: children come after their parent in preorder
+    for (int i = n - 1; i >= 0; --i) {
+        if (path.nodes[i]->is_leaf) {
+            subtree_sse[i] = node_sse(path.nodes[i]);
+            subtree_leaves[i] = 1;
+            collapsed[i] = true;
+        }
+        if (parents[i] >= 0) {
+            subtree_sse[parents[i]] += subtree_sse[i];
+            subtree_leaves[parents[i]] += subtree_leaves[i];
+        }
+    }
+
+    auto strength = [&](int i) {
+        return (node_sse(path.nodes[i]) - subtree_sse[i]) / (subtree_leaves[i] - 1);
+    };
+
+    // (g, node, leaves when pushed): an entry is outdated once the leaf count changed
+    using Entry = std::tuple<double, int, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+    for (int i = 0; i < n; ++i)
+        if (!collapsed[i])
+            heap.emplace(strength(i), i, subtree_leaves[i]);
+
+    path.alphas.push_back(0.0);
+    path.leaves.push_back(subtree_leaves[0]);
+    path.impurities.push_back(subtree_sse[0]);
+
+    double alpha = 0.0;
+    while (!heap.empty()) {
+        auto [g, i, leaves] = heap.top();
+        heap.pop();
+        if (collapsed[i] || leaves != subtree_leaves[i])
+            continue;
+
+        alpha = std::max(alpha, g);
+
+        // Collapse i: its remaining internal descendants disappear at the same alpha
+        for (int d = i; d < path.subtree_end[i]; ++d) {
+            if (!collapsed[d]) {
+                collapsed[d] = true;
+                path.prune_alpha[d] = alpha;
+            }
+        }
+
+        double removed_sse = subtree_sse[i] - node_sse(path.nodes[i]);
+        int removed_leaves = subtree_leaves[i] - 1;
+        subtree_sse[i] = node_sse(path.nodes[i]);
+        subtree_leaves[i] = 1;
+        for (int a = parents[i]; a >= 0; a = parents[a]) {
+            subtree_sse[a] -= removed_sse;
+            subtree_leaves[a] -= removed_leaves;
+            heap.emplace(strength(a), a, subtree_leaves[a]);
+        }
+
+        if (alpha > path.alphas.back()) {
+            path.alphas.push_back(alpha);
+            path.leaves.push_back(subtree_leaves[0]);
+            path.impurities.push_back(subtree_sse[0]);
+        } else {
+            path.leaves.back() = subtree_leaves[0];
+            path.impurities.back() = subtree_sse[0];
+        }
+    }
+
+    return path;
+}
+
+/**
+ * @brief Chooses the alpha of the path with the lowest validation MSE.
+ *
+ * The prediction of a row for a given alpha is the value of the shallowest
+ * node of its root-to-leaf path whose prune alpha is below alpha, so one walk
+ * per row gives its error for all the alphas of the path at once
+ * (difference array over the alphas). Ties go to the larger alpha (smaller tree).
+ *
+ * @return Selected alpha, 0 (no pruning) if the validation set is empty.
+ * @throws std::invalid_argument if X_val and y_val differ in size.
+ */
+double select_alpha(const PruningPath& path,
+                    const std::vector<std::vector<double>>& X_val,
+                    const std::vector<double>& y_val)
+{
+    if (X_val.size() != y_val.size())
+        throw std::invalid_argument("select_alpha: X_val and y_val differ in size");
+    if (X_val.empty())
+        return 0.0;
+
+    const std::vector<double>& alphas = path.alphas;
+    int k = alphas.size();
+    std::vector<double> diff(k + 1, 0.0);
+
+    auto first_alpha_at_least = [&](double a) {
+        return int(std::lower_bound(alphas.begin(), alphas.end(), a) - alphas.begin());
+    };
+
+    for (size_t r = 0; r < X_val.size(); ++r) {
+        int i = 0;                 // node index in preorder
+        int upper = k;             // alphas at or above this index use an ancestor
+        while (true) {
+            const Node* node = path.nodes[i];
+            int lower = node->is_leaf ? 0 : first_alpha_at_least(path.prune_alpha[i]);
+            // A leaf predicts its value (an empty leaf has no mean), a collapsed node its mean
+            double e = (node->is_leaf ? node->value : node->sum / node->samples) - y_val[r];
+            diff[lower] += e * e;
+            diff[upper] -= e * e;
+            upper = lower;
+            if (node->is_leaf || lower == 0)
+                break;
+            int left = i + 1;
+            i = X_val[r][node->feature_index] <= node->threshold ? left : path.subtree_end[left];
+        }
+    }
+
+    double best_alpha = 0.0, best_error = 0.0, error = 0.0;
+    for (int j = 0; j < k; ++j) {
+        error += diff[j];
+        if (j == 0 || error <= best_error) {
+            best_error = error;
+            best_alpha = alphas[j];
+        }
+    }
+    return best_alpha;
+}
+
+/**
+ * @brief Collapses, in place, every subtree whose prune alpha is at most alpha.
+ *
+ * The collapsed nodes become leaves predicting their mean; their descendants
+ * are released, so the path must not be used afterwards.
+ *
+ * @return Number of nodes removed.
+ */
+int prune_tree(const PruningPath& path, double alpha)
+{
+    int removed = 0;
+    int n = path.nodes.size();
+    for (int i = 0; i < n; ) {
+        Node* node = path.nodes[i];
+        if (!node->is_leaf && path.prune_alpha[i] <= alpha) {
+            removed += path.subtree_end[i] - i - 1;
+            free_tree(node->left);
+            free_tree(node->right);
+            node->left = nullptr;
+            node->right = nullptr;
+            node->is_leaf = true;
+            node->feature_index = -1;
+            node->value = node->sum / node->samples;
+            i = path.subtree_end[i];
+        } else {
+            ++i;
+        }
+    }
+    return removed;
+}
+
+/**
+ * @brief Prunes a tree with the alpha that minimizes the error on a validation set.
+ *
+ * An empty validation set leaves the tree unchanged.
+ *
+ * @return Selected alpha (0 if nothing was pruned).
+ */
+double prune_with_validation(Node* root,
+                             const std::vector<std::vector<double>>& X_val,
+                             const std::vector<double>& y_val)
+{
+    if (X_val.empty() && y_val.empty())
+        return 0.0;
+    PruningPath path = cost_complexity_path(root);
+    double alpha = select_alpha(path, X_val, y_val);
+    prune_tree(path, alpha);
+    return alpha;
+}
@@ -0,0 +1,38 @@
+#ifndef PRUNING_HPP
+#define PRUNING_HPP
+
+#include <vector>
+#include "decision_tree.hpp"
+
+/**
+ * @brief Minimal cost-complexity pruning path of a tree.
+ *
+ * nodes: nodes of the tree in preorder (left subtree first).
+ * subtree_end: index in nodes just after the last descendant of each node.
+ * prune_alpha: alpha from which each node becomes a leaf (0 for leaves).
+ * alphas: distinct alphas of the path, increasing, starting at 0.
+ * leaves / impurities: number of leaves and total SSE of the pruned tree at each alpha.
+ *
+ * The costs are SSE and collapsed nodes predict their mean, which fits the
+ * squared-error criteria only.
+ */
+struct PruningPath {
+    std::vector<Node*> nodes;
+    std::vector<int> subtree_end;
+    std::vector<double> prune_alpha;
+
+    std::vector<double> alphas;
+    std::vector<int> leaves;
+    std::vector<double> impurities;
+};
+
+PruningPath cost_complexity_path(Node* root);
+double select_alpha(const PruningPath& path,
+                    const std::vector<std::vector<double>>& X_val,
+                    const std::vector<double>& y_val);
+int prune_tree(const PruningPath& path, double alpha);
+double prune_with_validation(Node* root,
+                             const std::vector<std::vector<double>>& X_val,
+                             const std::vector<double>& y_val);
+
+#endif
@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include "quick_scorer.hpp"
+
+/**
+ * @brief Internal node of one tree, before grouping by feature.
+ */
+struct ScorerNode {
+    int feature;
+    double threshold;
+    int tree;
+    uint64_t mask;
+};
+
+/**
+ * @brief Numbers the leaves of a subtree from left to right.
+ *
+ * Every internal node gets the mask clearing the leaves of its left subtree.
+ *
+ * @param next_leaf Index of the next leaf to number (updated).
+ */
+static void collect_nodes(const Node* node, int tree, int& next_leaf,
+                          std::vector<double, HugePageAllocator<double>>& leaf_values,
+                          std::vector<ScorerNode>& nodes)
+{
+    if (node->is_leaf) {
+        leaf_values.push_back(node->value);
+        ++next_leaf;
+        return;
+    }
+
+    int first = next_leaf;
+    collect_nodes(node->left, tree, next_leaf, leaf_values, nodes);
+    int count = next_leaf - first;
+
+    uint64_t left_leaves = (count == 64 ? ~0ULL : ((1ULL << count) - 1)) << first;
+    nodes.push_back({node->feature_index, node->threshold, tree, ~left_leaves});
+
+    collect_nodes(node->right, tree, next_leaf, leaf_values, nodes);
+}
+
+/**
+ * @brief Prepares the feature-grouped node arrays of a forest.
+ *
+ * @param trees Roots of the trees of the ensemble (not owned).
+ * @throws std::invalid_argument if a root is null (unfitted model).
+ */
+QuickScorer::QuickScorer(const std::vector<Node*>& trees)
+{
+    std::vector<ScorerNode> nodes;
+    int n_features = 0;
+
+    for (Node* tree : trees) {
+        if (!tree)
+            throw std::invalid_argument("QuickScorer: null tree (unfitted model?)");
+        if (count_leaves(tree) > 64) {
+            large_trees.push_back(tree);
+            continue;
+        }
+        int next_leaf = 0;
+        leaf_begin.push_back(leaf_values.size());
+        collect_nodes(tree, n_trees, next_leaf, leaf_values, nodes);
+        ++n_trees;
+    }
+
+    for (const ScorerNode& node : nodes)
+        n_features = std::max(n_features, node.feature + 1);
+
+    std::stable_sort(nodes.begin(), nodes.end(), [](const ScorerNode& a, const ScorerNode& b) {
+        if (a.feature != b.feature)
+            return a.feature < b.feature;
+        return a.threshold < b.threshold;
+    });
+
+    feature_begin.assign(n_features + 1, 0);
+    for (const ScorerNode& node : nodes) {
+        ++feature_begin[node.feature + 1];
+        thresholds.push_back(node.threshold);
+        node_tree.push_back(node.tree);
+        node_mask.push_back(node.mask);
+    }
+    std::partial_sum(feature_begin.begin(), feature_begin.end(), feature_begin.begin());
+}
+
+/**
+ * @brief Sum of the outputs of all trees for one sample.
+ *
+ * @param masks Buffer of one leaf mask per tree (overwritten).
+ */
+double QuickScorer::score(const std::vector<double>& sample, std::vector<uint64_t>& masks) const
+{
+    std::fill(masks.begin(), masks.end(), ~0ULL);
+
+    int n_features = feature_begin.size() - 1;
+    for (int f = 0; f < n_features; ++f) {
+        // NaN goes right at every node, as in predict(Node*) where NaN <= t is false
+        double x = std::isnan(sample[f]) ? INFINITY : sample[f];
+        int end = feature_begin[f + 1];
+        for (int k = feature_begin[f]; k < end && thresholds[k] < x; ++k)
+            masks[node_tree[k]] &= node_mask[k];
+    }
+
+    double sum = 0.0;
+    for (int t = 0; t < n_trees; ++t)
+        sum += leaf_values[leaf_begin[t] + __builtin_ctzll(masks[t])];
+
+    for (Node* tree : large_trees)
+        sum += ::predict(tree, sample);
+    return sum;
+}
+
+/**
+ * @brief Predicts one sample: mean of the outputs of the trees (0 without trees).
+ */
+double QuickScorer::predict(const std::vector<double>& sample) const
+{
+    if (n_trees + large_trees.size() == 0) return 0.0;
+    std::vector<uint64_t> masks(n_trees);
+    return score(sample, masks) / (n_trees + large_trees.size());
+}
+
+/**
+ * @brief Predicts every row of X, reusing the same mask buffer.
+ */
+void QuickScorer::predict_batch(const std::vector<std::vector<double>>& X,
+                                std::vector<double>& out) const
+{
+    out.resize(X.size());
+    predict_rows(X, 0, X.size(), out.data());
+}
+
+/**
+ * @brief Predictions of rows [begin, end) of X, written to out[0 .. end - begin).
+ */
+void QuickScorer::predict_rows(const std::vector<std::vector<double>>& X,
+                               size_t begin, size_t end, double* out) const
+{
+    if (n_trees + large_trees.size() == 0) {
+        std::fill(out, out + (end - begin), 0.0);
+        return;
+    }
+    std::vector<uint64_t> masks(n_trees);
+    double scale = 1.0 / (n_trees + large_trees.size());
+
+    for (size_t i = begin; i < end; ++i)
+        out[i - begin] = score(X[i], masks) * scale;
+}
+
+/**
+ * @brief Batch prediction with one model replica per NUMA node.
+ *
+ * The rows are split in contiguous partitions (numa_parallel_for()); each
+ * partition is scored in a thread bound to a node, with that node's replica.
+ * Build the replicas with
+ *     NumaReplicas<QuickScorer> model([&] { return QuickScorer(trees); });
+ * Trees with more than 64 leaves stay shared (they are walked from the roots).
+ *
+ * @param n_threads Number of threads (0 = one per core).
+ */
+void predict_batch_numa(const NumaReplicas<QuickScorer>& model,
+                        const std::vector<std::vector<double>>& X,
+                        std::vector<double>& out,
+                        int n_threads)
+{
+    out.resize(X.size());
+    numa_parallel_for(X.size(), n_threads, [&](int node, size_t begin, size_t end) {
+        model.on_node(node).predict_rows(X, begin, end, out.data() + begin);
+    });
+}
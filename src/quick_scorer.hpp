@@ -0,0 +1,55 @@
+#ifndef QUICK_SCORER_HPP
+#define QUICK_SCORER_HPP
+
+#include <cstdint>
+#include <vector>
+#include "decision_tree.hpp"
+#include "numa.hpp"
+
+/**
+ * @brief Ensemble inference with the QuickScorer bitvector algorithm.
+ *
+ * The internal nodes of all trees are grouped by feature and sorted by
+ * threshold. For a sample, each feature's thresholds are scanned once, in
+ * increasing order, while they are below the sample value: those nodes send
+ * the sample to the right, so the leaves of their left subtree are cleared
+ * from the tree's 64-bit leaf mask. The exit leaf of each tree is then the
+ * lowest bit still set (count trailing zeros). No tree is walked node by node.
+ *
+ * Trees with more than 64 leaves cannot use a single mask and are evaluated
+ * with predict() instead.
+ */
+class QuickScorer {
+public:
+    explicit QuickScorer(const std::vector<Node*>& trees);
+
+    double predict(const std::vector<double>& sample) const;
+    void predict_batch(const std::vector<std::vector<double>>& X,
+                       std::vector<double>& out) const;
+    void predict_rows(const std::vector<std::vector<double>>& X,
+                      size_t begin, size_t end, double* out) const;
+
+private:
+    int n_trees = 0;
+
+    // Nodes of feature f are at [feature_begin[f], feature_begin[f + 1])
+    std::vector<int> feature_begin;
+    std::vector<double, HugePageAllocator<double>> thresholds;
+    std::vector<int, HugePageAllocator<int>> node_tree;
+    std::vector<uint64_t, HugePageAllocator<uint64_t>> node_mask;
+
+    // Leaf values of tree t are at leaf_begin[t] + leaf index
+    std::vector<int> leaf_begin;
+    std::vector<double, HugePageAllocator<double>> leaf_values;
+
+    std::vector<Node*> large_trees;
+
+    double score(const std::vector<double>& sample, std::vector<uint64_t>& masks) const;
+};
+
+void predict_batch_numa(const NumaReplicas<QuickScorer>& model,
+                        const std::vector<std::vector<double>>& X,
+                        std::vector<double>& out,
+                        int n_threads = 0);
+
+#endif
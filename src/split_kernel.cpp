@@ -0,0 +1,300 @@
+#include "split_kernel.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PPN_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using Kernel = SplitScore (*)(const double*, const double*, int, double, double, double,
+                              int, int, double, double);
+
+const double INF = std::numeric_limits<double>::infinity();
+
+/**
+ * @brief Scalar kernel, also used for the tail of the vector kernels.
+ *
+ * @param start First split position to score.
+ * @param end Last split position to score.
+ * @param left Sum of centered y over rows [0, start).
+ * @param left_sq Sum of squared centered y over rows [0, start).
+ * @param best Best split found before start (updated in place).
+ */
+void scan_scalar(const double* x, const double* y, int n, double c,
+                 double total, double total_sq,
+                 int start, int end, double left, double left_sq, SplitScore& best)
+{
+    for (int i = start; i <= end; ++i) {
+        double v = y[i] - c;
+        left += v;
+        left_sq += v * v;
+
+        if (!(x[i] < x[i + 1]))
+            continue;
+
+        double nl = i + 1;
+        double nr = n - nl;
+        double right = total - left;
+        double right_sq = total_sq - left_sq;
+        double sse = (left_sq - left * left / nl) + (right_sq - right * right / nr);
+
+        if (sse < best.sse) {
+            best.sse = sse;
+            best.index = i;
+        }
+    }
+}
+
+SplitScore kernel_scalar(const double* x, const double* y, int n,
+                         double c, double total, double total_sq,
+                         int start, int end, double left, double left_sq)
+{
+    SplitScore best;
+    best.sse = INF;
+    scan_scalar(x, y, n, c, total, total_sq, start, end, left, left_sq, best);
+    return best;
+}
+
+#ifdef PPN_X86_KERNELS
+
+/**
+ * @brief Keeps the smallest score (and the earliest index on ties) of the lanes.
+ */
+void reduce_lanes(const double* sse, const double* idx, int lanes, SplitScore& best)
+{
+    for (int l = 0; l < lanes; ++l) {
+        if (idx[l] < 0) continue;
+        int i = static_cast<int>(idx[l]);
+        if (sse[l] < best.sse || (sse[l] == best.sse && i < best.index)) {
+            best.sse = sse[l];
+            best.index = i;
+        }
+    }
+}
+
+/**
+ * @brief Inclusive prefix sum of the 4 lanes of a register.
+ */
+__attribute__((target("avx2")))
+inline __m256d scan4(__m256d v)
+{
+    const __m256d zero = _mm256_setzero_pd();
+    v = _mm256_add_pd(v, _mm256_blend_pd(_mm256_permute4x64_pd(v, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x1));
+    v = _mm256_add_pd(v, _mm256_blend_pd(_mm256_permute4x64_pd(v, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x3));
+    return v;
+}
+
+__attribute__((target("avx2")))
+SplitScore kernel_avx2(const double* x, const double* y, int n,
+                       double c, double total, double total_sq,
+                       int start, int end, double left0, double left_sq0)
+{
+    const __m256d vc = _mm256_set1_pd(c);
+    const __m256d vt = _mm256_set1_pd(total);
+    const __m256d vt2 = _mm256_set1_pd(total_sq);
+    const __m256d vn = _mm256_set1_pd(n);
+    const __m256d vinf = _mm256_set1_pd(INF);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d step = _mm256_set1_pd(4.0);
+
+    __m256d carry = _mm256_set1_pd(left0);
+    __m256d carry_sq = _mm256_set1_pd(left_sq0);
+    __m256d count = _mm256_add_pd(_mm256_set1_pd(start),    // rows in the left child
+                                  _mm256_setr_pd(1.0, 2.0, 3.0, 4.0));
+    __m256d best = vinf;
+    __m256d best_idx = _mm256_set1_pd(-1.0);
+
+    int i = start;
+    for (; i + 4 <= end + 1; i += 4) {
+        __m256d v = _mm256_sub_pd(_mm256_loadu_pd(y + i), vc);
+        __m256d left = _mm256_add_pd(scan4(v), carry);
+        __m256d left_sq = _mm256_add_pd(scan4(_mm256_mul_pd(v, v)), carry_sq);
+        carry = _mm256_permute4x64_pd(left, _MM_SHUFFLE(3, 3, 3, 3));
+        carry_sq = _mm256_permute4x64_pd(left_sq, _MM_SHUFFLE(3, 3, 3, 3));
+
+        __m256d right = _mm256_sub_pd(vt, left);
+        __m256d right_sq = _mm256_sub_pd(vt2, left_sq);
+        __m256d sse = _mm256_add_pd(
+            _mm256_sub_pd(left_sq, _mm256_div_pd(_mm256_mul_pd(left, left), count)),
+            _mm256_sub_pd(right_sq, _mm256_div_pd(_mm256_mul_pd(right, right), _mm256_sub_pd(vn, count))));
+
+        // Only boundaries between two distinct values are real thresholds
+        __m256d valid = _mm256_cmp_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(x + i + 1), _CMP_LT_OQ);
+        sse = _mm256_blendv_pd(vinf, sse, valid);
+
+        __m256d better = _mm256_cmp_pd(sse, best, _CMP_LT_OQ);
+        best = _mm256_blendv_pd(best, sse, better);
+        best_idx = _mm256_blendv_pd(best_idx, _mm256_sub_pd(count, one), better);
+        count = _mm256_add_pd(count, step);
+    }
+
+    alignas(32) double lane_sse[4];
+    alignas(32) double lane_idx[4];
+    _mm256_store_pd(lane_sse, best);
+    _mm256_store_pd(lane_idx, best_idx);
+
+    SplitScore result;
+    result.sse = INF;
+    reduce_lanes(lane_sse, lane_idx, 4, result);
+    scan_scalar(x, y, n, c, total, total_sq, i, end,
+                _mm256_cvtsd_f64(carry), _mm256_cvtsd_f64(carry_sq), result);
+    return result;
+}
+
+/**
+ * @brief Inclusive prefix sum of the 8 lanes of a register.
+ */
+__attribute__((target("avx512f")))
+inline __m512d scan8(__m512d v)
+{
+    v = _mm512_add_pd(v, _mm512_maskz_permutexvar_pd(0xFE, _mm512_setr_epi64(0, 0, 1, 2, 3, 4, 5, 6), v));
+    v = _mm512_add_pd(v, _mm512_maskz_permutexvar_pd(0xFC, _mm512_setr_epi64(0, 0, 0, 1, 2, 3, 4, 5), v));
+    v = _mm512_add_pd(v, _mm512_maskz_permutexvar_pd(0xF0, _mm512_setr_epi64(0, 0, 0, 0, 0, 1, 2, 3), v));
+    return v;
+}
+
+__attribute__((target("avx512f")))
+SplitScore kernel_avx512(const double* x, const double* y, int n,
+                         double c, double total, double total_sq,
+                         int start, int end, double left0, double left_sq0)
+{
+    const __m512d vc = _mm512_set1_pd(c);
+    const __m512d vt = _mm512_set1_pd(total);
+    const __m512d vt2 = _mm512_set1_pd(total_sq);
+    const __m512d vn = _mm512_set1_pd(n);
+    const __m512d vinf = _mm512_set1_pd(INF);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d step = _mm512_set1_pd(8.0);
+    const __m512i last = _mm512_set1_epi64(7);
+
+    __m512d carry = _mm512_set1_pd(left0);
+    __m512d carry_sq = _mm512_set1_pd(left_sq0);
+    __m512d count = _mm512_add_pd(_mm512_set1_pd(start),
+                                  _mm512_setr_pd(1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0));
+    __m512d best = vinf;
+    __m512d best_idx = _mm512_set1_pd(-1.0);
+
+    int i = start;
+    for (; i + 8 <= end + 1; i += 8) {
+        __m512d v = _mm512_sub_pd(_mm512_loadu_pd(y + i), vc);
+        __m512d left = _mm512_add_pd(scan8(v), carry);
+        __m512d left_sq = _mm512_add_pd(scan8(_mm512_mul_pd(v, v)), carry_sq);
+        carry = _mm512_mask_permutexvar_pd(left, 0xFF, last, left);
+        carry_sq = _mm512_mask_permutexvar_pd(left_sq, 0xFF, last, left_sq);
+
+        __m512d right = _mm512_sub_pd(vt, left);
+        __m512d right_sq = _mm512_sub_pd(vt2, left_sq);
+        __m512d sse = _mm512_add_pd(
+            _mm512_sub_pd(left_sq, _mm512_div_pd(_mm512_mul_pd(left, left), count)),
+            _mm512_sub_pd(right_sq, _mm512_div_pd(_mm512_mul_pd(right, right), _mm512_sub_pd(vn, count))));
+
+        __mmask8 valid = _mm512_cmp_pd_mask(_mm512_loadu_pd(x + i), _mm512_loadu_pd(x + i + 1), _CMP_LT_OQ);
+        sse = _mm512_mask_blend_pd(valid, vinf, sse);
+
+        __mmask8 better = _mm512_cmp_pd_mask(sse, best, _CMP_LT_OQ);
+        best = _mm512_mask_blend_pd(better, best, sse);
+        best_idx = _mm512_mask_blend_pd(better, best_idx, _mm512_sub_pd(count, one));
+        count = _mm512_add_pd(count, step);
+    }
+
+    alignas(64) double lane_sse[8];
+    alignas(64) double lane_idx[8];
+    _mm512_store_pd(lane_sse, best);
+    _mm512_store_pd(lane_idx, best_idx);
+
+    SplitScore result;
+    result.sse = INF;
+    reduce_lanes(lane_sse, lane_idx, 8, result);
+    scan_scalar(x, y, n, c, total, total_sq, i, end,
+                _mm512_cvtsd_f64(carry), _mm512_cvtsd_f64(carry_sq), result);
+    return result;
+}
+
+#endif
+
+struct KernelChoice {
+    Kernel kernel;
+    const char* name;
+};
+
+/**
+ * @brief Picks the widest kernel supported by the CPU.
+ *
+ * The environment variable PPN_SPLIT_KERNEL ("scalar", "avx2") can force a
+ * narrower kernel, which is useful to compare the versions.
+ */
+KernelChoice select_kernel()
+{
+    const char* forced = std::getenv("PPN_SPLIT_KERNEL");
+    bool allow_avx512 = !forced || std::strcmp(forced, "avx512") == 0;
+    bool allow_avx2 = allow_avx512 || std::strcmp(forced, "avx2") == 0;
+
+#ifdef PPN_X86_KERNELS
+    __builtin_cpu_init();
+    if (allow_avx512 && __builtin_cpu_supports("avx512f"))
+        return {kernel_avx512, "avx512"};
+    if (allow_avx2 && __builtin_cpu_supports("avx2"))
+        return {kernel_avx2, "avx2"};
+#else
+    (void)allow_avx2;
+#endif
+    return {kernel_scalar, "scalar"};
+}
+
+const KernelChoice& kernel_choice()
+{
+    static const KernelChoice choice = select_kernel();
+    return choice;
+}
+
+} // namespace
+
+SplitScore best_mse_split(const double* x, const double* y, int n, int min_leaf)
+{
+    SplitScore result;
+    if (n <= 0) return result;
+
+    // Center y on the node mean so the prefix sums stay well conditioned
+    double c = 0.0;
+    for (int i = 0; i < n; ++i) c += y[i];
+    c /= n;
+
+    double total = 0.0, total_sq = 0.0;
+    for (int i = 0; i < n; ++i) {
+        double v = y[i] - c;
+        total += v;
+        total_sq += v * v;
+    }
+
+    result.parent_sse = total_sq - total * total / n;
+    result.sse = result.parent_sse;
+
+    // Split positions leaving at least min_leaf rows on each side
+    if (min_leaf < 1) min_leaf = 1;
+    int start = min_leaf - 1;
+    int end = n - min_leaf - 1;
+    if (start > end) return result;
+
+    double left = 0.0, left_sq = 0.0;
+    for (int i = 0; i < start; ++i) {
+        double v = y[i] - c;
+        left += v;
+        left_sq += v * v;
+    }
+
+    SplitScore best = kernel_choice().kernel(x, y, n, c, total, total_sq,
+                                             start, end, left, left_sq);
+    result.index = best.index;
+    result.sse = best.index < 0 ? result.parent_sse : (best.sse < 0.0 ? 0.0 : best.sse);
+    return result;
+}
+
+const char* split_kernel_name()
+{
+    return kernel_choice().name;
+}
@@ -0,0 +1,40 @@
+#ifndef SPLIT_KERNEL_HPP
+#define SPLIT_KERNEL_HPP
+
+/**
+ * @brief Result of scoring every threshold of one feature.
+ *
+ * index: position i of the best split in the sorted order, the left child
+ *        holds rows [0, i] and the threshold lies between x[i] and x[i+1]
+ *        (-1 if the feature has a single distinct value).
+ * sse: sum of squared errors of the two children for the best split.
+ * parent_sse: sum of squared errors of the node before the split.
+ */
+struct SplitScore {
+    int index = -1;
+    double sse = 0.0;
+    double parent_sse = 0.0;
+};
+
+/**
+ * @brief Scores all thresholds of a feature sorted in ascending order.
+ *
+ * Prefix sums of y and y² are built on the fly and the weighted variance of
+ * both children is evaluated for every boundary between two distinct values,
+ * keeping the first minimum (fused argmin, no intermediate arrays).
+ * The AVX-512 / AVX2 / scalar version is chosen once at runtime.
+ *
+ * @param x Feature values sorted in ascending order (n values).
+ * @param y Target values in the same order as x (n values).
+ * @param n Number of samples in the node.
+ * @param min_leaf Minimum number of samples in each child.
+ * @return Best split position and its sum of squared errors.
+ */
+SplitScore best_mse_split(const double* x, const double* y, int n, int min_leaf = 1);
+
+/**
+ * @brief Name of the kernel selected for this CPU ("avx512", "avx2" or "scalar").
+ */
+const char* split_kernel_name();
+
+#endif